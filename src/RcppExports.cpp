@@ -10,16 +10,56 @@ Rcpp::Rostream<true>&  Rcpp::Rcout = Rcpp::Rcpp_cout_get();
 Rcpp::Rostream<false>& Rcpp::Rcerr = Rcpp::Rcpp_cerr_get();
 #endif
 
+// cell_area_rows
+Rcpp::NumericVector cell_area_rows(Rcpp::NumericVector& extent, Rcpp::IntegerVector& dimension);
+RcppExport SEXP _controlledburn_cell_area_rows(SEXP extentSEXP, SEXP dimensionSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type extent(extentSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    rcpp_result_gen = Rcpp::wrap(cell_area_rows(extent, dimension));
+    return rcpp_result_gen;
+END_RCPP
+}
+// span_area
+Rcpp::NumericVector span_area(Rcpp::List& index, Rcpp::NumericVector& extent, Rcpp::IntegerVector& dimension);
+RcppExport SEXP _controlledburn_span_area(SEXP indexSEXP, SEXP extentSEXP, SEXP dimensionSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List& >::type index(indexSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type extent(extentSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    rcpp_result_gen = Rcpp::wrap(span_area(index, extent, dimension));
+    return rcpp_result_gen;
+END_RCPP
+}
+// span_weighted_mean
+Rcpp::NumericVector span_weighted_mean(Rcpp::List& index, Rcpp::NumericVector& extent, Rcpp::IntegerVector& dimension, Rcpp::NumericVector& values);
+RcppExport SEXP _controlledburn_span_weighted_mean(SEXP indexSEXP, SEXP extentSEXP, SEXP dimensionSEXP, SEXP valuesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List& >::type index(indexSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type extent(extentSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type values(valuesSEXP);
+    rcpp_result_gen = Rcpp::wrap(span_weighted_mean(index, extent, dimension, values));
+    return rcpp_result_gen;
+END_RCPP
+}
 // burn_polygon
-Rcpp::List burn_polygon(Rcpp::DataFrame& sf, Rcpp::NumericVector& extent, Rcpp::IntegerVector& dimension);
-RcppExport SEXP _controlledburn_burn_polygon(SEXP sfSEXP, SEXP extentSEXP, SEXP dimensionSEXP) {
+Rcpp::List burn_polygon(Rcpp::DataFrame& sf, Rcpp::NumericVector& extent, Rcpp::IntegerVector& dimension, std::string engine);
+RcppExport SEXP _controlledburn_burn_polygon(SEXP sfSEXP, SEXP extentSEXP, SEXP dimensionSEXP, SEXP engineSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< Rcpp::DataFrame& >::type sf(sfSEXP);
     Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type extent(extentSEXP);
     Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
-    rcpp_result_gen = Rcpp::wrap(burn_polygon(sf, extent, dimension));
+    Rcpp::traits::input_parameter< std::string >::type engine(engineSEXP);
+    rcpp_result_gen = Rcpp::wrap(burn_polygon(sf, extent, dimension, engine));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -36,10 +76,585 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// burn_async_start
+SEXP burn_async_start(Rcpp::DataFrame& sf, Rcpp::NumericVector& extent, Rcpp::IntegerVector& dimension);
+RcppExport SEXP _controlledburn_burn_async_start(SEXP sfSEXP, SEXP extentSEXP, SEXP dimensionSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::DataFrame& >::type sf(sfSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type extent(extentSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    rcpp_result_gen = Rcpp::wrap(burn_async_start(sf, extent, dimension));
+    return rcpp_result_gen;
+END_RCPP
+}
+// burn_async_done
+bool burn_async_done(SEXP handle);
+RcppExport SEXP _controlledburn_burn_async_done(SEXP handleSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type handle(handleSEXP);
+    rcpp_result_gen = Rcpp::wrap(burn_async_done(handle));
+    return rcpp_result_gen;
+END_RCPP
+}
+// burn_async_progress
+double burn_async_progress(SEXP handle);
+RcppExport SEXP _controlledburn_burn_async_progress(SEXP handleSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type handle(handleSEXP);
+    rcpp_result_gen = Rcpp::wrap(burn_async_progress(handle));
+    return rcpp_result_gen;
+END_RCPP
+}
+// burn_async_cancel
+void burn_async_cancel(SEXP handle);
+RcppExport SEXP _controlledburn_burn_async_cancel(SEXP handleSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type handle(handleSEXP);
+    burn_async_cancel(handle);
+    return R_NilValue;
+END_RCPP
+}
+// burn_async_collect
+Rcpp::List burn_async_collect(SEXP handle);
+RcppExport SEXP _controlledburn_burn_async_collect(SEXP handleSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type handle(handleSEXP);
+    rcpp_result_gen = Rcpp::wrap(burn_async_collect(handle));
+    return rcpp_result_gen;
+END_RCPP
+}
+// burn_polygon_time
+Rcpp::List burn_polygon_time(Rcpp::DataFrame& sf, Rcpp::NumericVector& extent, Rcpp::IntegerVector& dimension, Rcpp::NumericVector& start, Rcpp::NumericVector& end, Rcpp::NumericVector& time);
+RcppExport SEXP _controlledburn_burn_polygon_time(SEXP sfSEXP, SEXP extentSEXP, SEXP dimensionSEXP, SEXP startSEXP, SEXP endSEXP, SEXP timeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::DataFrame& >::type sf(sfSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type extent(extentSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type start(startSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type end(endSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type time(timeSEXP);
+    rcpp_result_gen = Rcpp::wrap(burn_polygon_time(sf, extent, dimension, start, end, time));
+    return rcpp_result_gen;
+END_RCPP
+}
+// materialize_cube
+Rcpp::IntegerVector materialize_cube(Rcpp::List& index, Rcpp::IntegerVector& dimension, int nlayer);
+RcppExport SEXP _controlledburn_materialize_cube(SEXP indexSEXP, SEXP dimensionSEXP, SEXP nlayerSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List& >::type index(indexSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    Rcpp::traits::input_parameter< int >::type nlayer(nlayerSEXP);
+    rcpp_result_gen = Rcpp::wrap(materialize_cube(index, dimension, nlayer));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cube_slice
+Rcpp::List cube_slice(Rcpp::List& index, int layer);
+RcppExport SEXP _controlledburn_cube_slice(SEXP indexSEXP, SEXP layerSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List& >::type index(indexSEXP);
+    Rcpp::traits::input_parameter< int >::type layer(layerSEXP);
+    rcpp_result_gen = Rcpp::wrap(cube_slice(index, layer));
+    return rcpp_result_gen;
+END_RCPP
+}
+// burn_polygon_z
+Rcpp::List burn_polygon_z(Rcpp::DataFrame& sf, Rcpp::NumericVector& extent, Rcpp::IntegerVector& dimension, Rcpp::NumericVector& zmin, Rcpp::NumericVector& zmax, Rcpp::NumericVector& zgrid);
+RcppExport SEXP _controlledburn_burn_polygon_z(SEXP sfSEXP, SEXP extentSEXP, SEXP dimensionSEXP, SEXP zminSEXP, SEXP zmaxSEXP, SEXP zgridSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::DataFrame& >::type sf(sfSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type extent(extentSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type zmin(zminSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type zmax(zmaxSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type zgrid(zgridSEXP);
+    rcpp_result_gen = Rcpp::wrap(burn_polygon_z(sf, extent, dimension, zmin, zmax, zgrid));
+    return rcpp_result_gen;
+END_RCPP
+}
+// burn_polygon_processes
+std::string burn_polygon_processes(Rcpp::DataFrame& sf, Rcpp::NumericVector& extent, Rcpp::IntegerVector& dimension, std::string path, int workers, int bands, SEXP breaks);
+RcppExport SEXP _controlledburn_burn_polygon_processes(SEXP sfSEXP, SEXP extentSEXP, SEXP dimensionSEXP, SEXP pathSEXP, SEXP workersSEXP, SEXP bandsSEXP, SEXP breaksSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::DataFrame& >::type sf(sfSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type extent(extentSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    Rcpp::traits::input_parameter< int >::type workers(workersSEXP);
+    Rcpp::traits::input_parameter< int >::type bands(bandsSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type breaks(breaksSEXP);
+    rcpp_result_gen = Rcpp::wrap(burn_polygon_processes(sf, extent, dimension, path, workers, bands, breaks));
+    return rcpp_result_gen;
+END_RCPP
+}
+// engine_list_edges
+double engine_list_edges(SEXP edges);
+RcppExport SEXP _controlledburn_engine_list_edges(SEXP edgesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type edges(edgesSEXP);
+    rcpp_result_gen = Rcpp::wrap(engine_list_edges(edges));
+    return rcpp_result_gen;
+END_RCPP
+}
+// burn_calibrate
+Rcpp::List burn_calibrate(Rcpp::IntegerVector dimension);
+RcppExport SEXP _controlledburn_burn_calibrate(SEXP dimensionSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type dimension(dimensionSEXP);
+    rcpp_result_gen = Rcpp::wrap(burn_calibrate(dimension));
+    return rcpp_result_gen;
+END_RCPP
+}
+// point_density
+Rcpp::NumericVector point_density(Rcpp::NumericVector& x, Rcpp::NumericVector& y, Rcpp::NumericVector& extent, Rcpp::IntegerVector& dimension, double bandwidth, std::string kernel, SEXP weights);
+RcppExport SEXP _controlledburn_point_density(SEXP xSEXP, SEXP ySEXP, SEXP extentSEXP, SEXP dimensionSEXP, SEXP bandwidthSEXP, SEXP kernelSEXP, SEXP weightsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type x(xSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type y(ySEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type extent(extentSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    Rcpp::traits::input_parameter< double >::type bandwidth(bandwidthSEXP);
+    Rcpp::traits::input_parameter< std::string >::type kernel(kernelSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type weights(weightsSEXP);
+    rcpp_result_gen = Rcpp::wrap(point_density(x, y, extent, dimension, bandwidth, kernel, weights));
+    return rcpp_result_gen;
+END_RCPP
+}
+// disaggregate
+SEXP disaggregate(Rcpp::List& index, Rcpp::IntegerVector& dimension, Rcpp::NumericVector& totals, SEXP weights, bool dense);
+RcppExport SEXP _controlledburn_disaggregate(SEXP indexSEXP, SEXP dimensionSEXP, SEXP totalsSEXP, SEXP weightsSEXP, SEXP denseSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List& >::type index(indexSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type totals(totalsSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type weights(weightsSEXP);
+    Rcpp::traits::input_parameter< bool >::type dense(denseSEXP);
+    rcpp_result_gen = Rcpp::wrap(disaggregate(index, dimension, totals, weights, dense));
+    return rcpp_result_gen;
+END_RCPP
+}
+// burn_polygon_dissolve
+Rcpp::List burn_polygon_dissolve(Rcpp::DataFrame& sf, Rcpp::NumericVector& extent, Rcpp::IntegerVector& dimension, Rcpp::IntegerVector& group);
+RcppExport SEXP _controlledburn_burn_polygon_dissolve(SEXP sfSEXP, SEXP extentSEXP, SEXP dimensionSEXP, SEXP groupSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::DataFrame& >::type sf(sfSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type extent(extentSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type group(groupSEXP);
+    rcpp_result_gen = Rcpp::wrap(burn_polygon_dissolve(sf, extent, dimension, group));
+    return rcpp_result_gen;
+END_RCPP
+}
+// extract_line
+Rcpp::NumericMatrix extract_line(Rcpp::DataFrame& sf, Rcpp::NumericVector& extent, Rcpp::IntegerVector& dimension, SEXP values, double offset);
+RcppExport SEXP _controlledburn_extract_line(SEXP sfSEXP, SEXP extentSEXP, SEXP dimensionSEXP, SEXP valuesSEXP, SEXP offsetSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::DataFrame& >::type sf(sfSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type extent(extentSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type values(valuesSEXP);
+    Rcpp::traits::input_parameter< double >::type offset(offsetSEXP);
+    rcpp_result_gen = Rcpp::wrap(extract_line(sf, extent, dimension, values, offset));
+    return rcpp_result_gen;
+END_RCPP
+}
+// focal_coverage
+Rcpp::NumericVector focal_coverage(Rcpp::List& index, Rcpp::IntegerVector& dimension, Rcpp::IntegerVector& size, int poly_id, bool fraction);
+RcppExport SEXP _controlledburn_focal_coverage(SEXP indexSEXP, SEXP dimensionSEXP, SEXP sizeSEXP, SEXP poly_idSEXP, SEXP fractionSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List& >::type index(indexSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type size(sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type poly_id(poly_idSEXP);
+    Rcpp::traits::input_parameter< bool >::type fraction(fractionSEXP);
+    rcpp_result_gen = Rcpp::wrap(focal_coverage(index, dimension, size, poly_id, fraction));
+    return rcpp_result_gen;
+END_RCPP
+}
+// extract_mosaic
+Rcpp::NumericMatrix extract_mosaic(Rcpp::List& index, Rcpp::IntegerVector& dimension, Rcpp::CharacterVector& files, Rcpp::IntegerVector& block_dimension, bool compressed, double cache_mb);
+RcppExport SEXP _controlledburn_extract_mosaic(SEXP indexSEXP, SEXP dimensionSEXP, SEXP filesSEXP, SEXP block_dimensionSEXP, SEXP compressedSEXP, SEXP cache_mbSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List& >::type index(indexSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector& >::type files(filesSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type block_dimension(block_dimensionSEXP);
+    Rcpp::traits::input_parameter< bool >::type compressed(compressedSEXP);
+    Rcpp::traits::input_parameter< double >::type cache_mb(cache_mbSEXP);
+    rcpp_result_gen = Rcpp::wrap(extract_mosaic(index, dimension, files, block_dimension, compressed, cache_mb));
+    return rcpp_result_gen;
+END_RCPP
+}
+// mosaic_cache_info
+Rcpp::List mosaic_cache_info();
+RcppExport SEXP _controlledburn_mosaic_cache_info() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(mosaic_cache_info());
+    return rcpp_result_gen;
+END_RCPP
+}
+// burn_polygon_oriented
+Rcpp::List burn_polygon_oriented(Rcpp::DataFrame& sf, Rcpp::NumericVector& extent, Rcpp::IntegerVector& dimension, bool column_major, bool south_up);
+RcppExport SEXP _controlledburn_burn_polygon_oriented(SEXP sfSEXP, SEXP extentSEXP, SEXP dimensionSEXP, SEXP column_majorSEXP, SEXP south_upSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::DataFrame& >::type sf(sfSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type extent(extentSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    Rcpp::traits::input_parameter< bool >::type column_major(column_majorSEXP);
+    Rcpp::traits::input_parameter< bool >::type south_up(south_upSEXP);
+    rcpp_result_gen = Rcpp::wrap(burn_polygon_oriented(sf, extent, dimension, column_major, south_up));
+    return rcpp_result_gen;
+END_RCPP
+}
+// materialize_oriented
+Rcpp::IntegerVector materialize_oriented(Rcpp::List& index, Rcpp::IntegerVector& dimension, bool column_major);
+RcppExport SEXP _controlledburn_materialize_oriented(SEXP indexSEXP, SEXP dimensionSEXP, SEXP column_majorSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List& >::type index(indexSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    Rcpp::traits::input_parameter< bool >::type column_major(column_majorSEXP);
+    rcpp_result_gen = Rcpp::wrap(materialize_oriented(index, dimension, column_major));
+    return rcpp_result_gen;
+END_RCPP
+}
+// plan_row_bands
+Rcpp::List plan_row_bands(Rcpp::DataFrame& sf, Rcpp::NumericVector& extent, Rcpp::IntegerVector& dimension, int parts);
+RcppExport SEXP _controlledburn_plan_row_bands(SEXP sfSEXP, SEXP extentSEXP, SEXP dimensionSEXP, SEXP partsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::DataFrame& >::type sf(sfSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type extent(extentSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    Rcpp::traits::input_parameter< int >::type parts(partsSEXP);
+    rcpp_result_gen = Rcpp::wrap(plan_row_bands(sf, extent, dimension, parts));
+    return rcpp_result_gen;
+END_RCPP
+}
+// burn_polygon_part
+SEXP burn_polygon_part(Rcpp::DataFrame& sf, Rcpp::NumericVector& extent, Rcpp::IntegerVector& dimension, Rcpp::IntegerVector& breaks, int part, std::string path);
+RcppExport SEXP _controlledburn_burn_polygon_part(SEXP sfSEXP, SEXP extentSEXP, SEXP dimensionSEXP, SEXP breaksSEXP, SEXP partSEXP, SEXP pathSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::DataFrame& >::type sf(sfSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type extent(extentSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type breaks(breaksSEXP);
+    Rcpp::traits::input_parameter< int >::type part(partSEXP);
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    rcpp_result_gen = Rcpp::wrap(burn_polygon_part(sf, extent, dimension, breaks, part, path));
+    return rcpp_result_gen;
+END_RCPP
+}
+// merge_spanfiles
+std::string merge_spanfiles(Rcpp::CharacterVector& paths, std::string path);
+RcppExport SEXP _controlledburn_merge_spanfiles(SEXP pathsSEXP, SEXP pathSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::CharacterVector& >::type paths(pathsSEXP);
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    rcpp_result_gen = Rcpp::wrap(merge_spanfiles(paths, path));
+    return rcpp_result_gen;
+END_RCPP
+}
+// merge_span_lists
+Rcpp::List merge_span_lists(Rcpp::List& parts);
+RcppExport SEXP _controlledburn_merge_span_lists(SEXP partsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List& >::type parts(partsSEXP);
+    rcpp_result_gen = Rcpp::wrap(merge_span_lists(parts));
+    return rcpp_result_gen;
+END_RCPP
+}
+// burn_wkb_pipeline
+SEXP burn_wkb_pipeline(Rcpp::List& wkb, Rcpp::NumericVector& extent, Rcpp::IntegerVector& dimension, int workers, int queue_depth, std::string path);
+RcppExport SEXP _controlledburn_burn_wkb_pipeline(SEXP wkbSEXP, SEXP extentSEXP, SEXP dimensionSEXP, SEXP workersSEXP, SEXP queue_depthSEXP, SEXP pathSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List& >::type wkb(wkbSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type extent(extentSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    Rcpp::traits::input_parameter< int >::type workers(workersSEXP);
+    Rcpp::traits::input_parameter< int >::type queue_depth(queue_depthSEXP);
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    rcpp_result_gen = Rcpp::wrap(burn_wkb_pipeline(wkb, extent, dimension, workers, queue_depth, path));
+    return rcpp_result_gen;
+END_RCPP
+}
+// pool_inline_cost
+double pool_inline_cost(SEXP cost);
+RcppExport SEXP _controlledburn_pool_inline_cost(SEXP costSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cost(costSEXP);
+    rcpp_result_gen = Rcpp::wrap(pool_inline_cost(cost));
+    return rcpp_result_gen;
+END_RCPP
+}
+// pool_selftest
+Rcpp::IntegerVector pool_selftest(int n, int m, int fail);
+RcppExport SEXP _controlledburn_pool_selftest(SEXP nSEXP, SEXP mSEXP, SEXP failSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type n(nSEXP);
+    Rcpp::traits::input_parameter< int >::type m(mSEXP);
+    Rcpp::traits::input_parameter< int >::type fail(failSEXP);
+    rcpp_result_gen = Rcpp::wrap(pool_selftest(n, m, fail));
+    return rcpp_result_gen;
+END_RCPP
+}
+// burn_polygon_refine
+Rcpp::List burn_polygon_refine(Rcpp::DataFrame& sf, Rcpp::List& index, Rcpp::NumericVector& extent, Rcpp::IntegerVector& dimension, int factor);
+RcppExport SEXP _controlledburn_burn_polygon_refine(SEXP sfSEXP, SEXP indexSEXP, SEXP extentSEXP, SEXP dimensionSEXP, SEXP factorSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::DataFrame& >::type sf(sfSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List& >::type index(indexSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type extent(extentSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    Rcpp::traits::input_parameter< int >::type factor(factorSEXP);
+    rcpp_result_gen = Rcpp::wrap(burn_polygon_refine(sf, index, extent, dimension, factor));
+    return rcpp_result_gen;
+END_RCPP
+}
+// span_reindex
+Rcpp::List span_reindex(Rcpp::List& index, Rcpp::NumericVector& extent, Rcpp::IntegerVector& dimension, Rcpp::NumericVector& new_extent, Rcpp::IntegerVector& new_dimension);
+RcppExport SEXP _controlledburn_span_reindex(SEXP indexSEXP, SEXP extentSEXP, SEXP dimensionSEXP, SEXP new_extentSEXP, SEXP new_dimensionSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List& >::type index(indexSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type extent(extentSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type new_extent(new_extentSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type new_dimension(new_dimensionSEXP);
+    rcpp_result_gen = Rcpp::wrap(span_reindex(index, extent, dimension, new_extent, new_dimension));
+    return rcpp_result_gen;
+END_RCPP
+}
+// simd_info
+Rcpp::List simd_info();
+RcppExport SEXP _controlledburn_simd_info() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(simd_info());
+    return rcpp_result_gen;
+END_RCPP
+}
+// read_spanfile
+Rcpp::List read_spanfile(std::string path);
+RcppExport SEXP _controlledburn_read_spanfile(SEXP pathSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    rcpp_result_gen = Rcpp::wrap(read_spanfile(path));
+    return rcpp_result_gen;
+END_RCPP
+}
+// burn_polygon_sorted
+std::string burn_polygon_sorted(Rcpp::DataFrame& sf, Rcpp::NumericVector& extent, Rcpp::IntegerVector& dimension, std::string path, double memory_mb);
+RcppExport SEXP _controlledburn_burn_polygon_sorted(SEXP sfSEXP, SEXP extentSEXP, SEXP dimensionSEXP, SEXP pathSEXP, SEXP memory_mbSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::DataFrame& >::type sf(sfSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type extent(extentSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    Rcpp::traits::input_parameter< double >::type memory_mb(memory_mbSEXP);
+    rcpp_result_gen = Rcpp::wrap(burn_polygon_sorted(sf, extent, dimension, path, memory_mb));
+    return rcpp_result_gen;
+END_RCPP
+}
+// burn_stream
+Rcpp::NumericVector burn_stream(Rcpp::DataFrame& sf, Rcpp::NumericVector& extent, Rcpp::IntegerVector& dimension, Rcpp::NumericVector& dem, double drop, int window, bool monotone);
+RcppExport SEXP _controlledburn_burn_stream(SEXP sfSEXP, SEXP extentSEXP, SEXP dimensionSEXP, SEXP demSEXP, SEXP dropSEXP, SEXP windowSEXP, SEXP monotoneSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::DataFrame& >::type sf(sfSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type extent(extentSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type dem(demSEXP);
+    Rcpp::traits::input_parameter< double >::type drop(dropSEXP);
+    Rcpp::traits::input_parameter< int >::type window(windowSEXP);
+    Rcpp::traits::input_parameter< bool >::type monotone(monotoneSEXP);
+    rcpp_result_gen = Rcpp::wrap(burn_stream(sf, extent, dimension, dem, drop, window, monotone));
+    return rcpp_result_gen;
+END_RCPP
+}
+// tile_cover
+Rcpp::List tile_cover(Rcpp::DataFrame& sf, Rcpp::IntegerVector& zoom);
+RcppExport SEXP _controlledburn_tile_cover(SEXP sfSEXP, SEXP zoomSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::DataFrame& >::type sf(sfSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type zoom(zoomSEXP);
+    rcpp_result_gen = Rcpp::wrap(tile_cover(sf, zoom));
+    return rcpp_result_gen;
+END_RCPP
+}
+// trace_enabled
+bool trace_enabled();
+RcppExport SEXP _controlledburn_trace_enabled() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(trace_enabled());
+    return rcpp_result_gen;
+END_RCPP
+}
+// trace_write
+double trace_write(std::string path);
+RcppExport SEXP _controlledburn_trace_write(SEXP pathSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    rcpp_result_gen = Rcpp::wrap(trace_write(path));
+    return rcpp_result_gen;
+END_RCPP
+}
+// burn_polygon_trapezoids
+Rcpp::List burn_polygon_trapezoids(Rcpp::DataFrame& sf, Rcpp::NumericVector& extent, Rcpp::IntegerVector& dimension);
+RcppExport SEXP _controlledburn_burn_polygon_trapezoids(SEXP sfSEXP, SEXP extentSEXP, SEXP dimensionSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::DataFrame& >::type sf(sfSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type extent(extentSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    rcpp_result_gen = Rcpp::wrap(burn_polygon_trapezoids(sf, extent, dimension));
+    return rcpp_result_gen;
+END_RCPP
+}
+// trapezoid_spans
+Rcpp::List trapezoid_spans(Rcpp::List& index, Rcpp::IntegerVector& dimension, int first_row, int last_row);
+RcppExport SEXP _controlledburn_trapezoid_spans(SEXP indexSEXP, SEXP dimensionSEXP, SEXP first_rowSEXP, SEXP last_rowSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List& >::type index(indexSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    Rcpp::traits::input_parameter< int >::type first_row(first_rowSEXP);
+    Rcpp::traits::input_parameter< int >::type last_row(last_rowSEXP);
+    rcpp_result_gen = Rcpp::wrap(trapezoid_spans(index, dimension, first_row, last_row));
+    return rcpp_result_gen;
+END_RCPP
+}
+// burn_polygon_checked
+Rcpp::List burn_polygon_checked(Rcpp::DataFrame& sf, Rcpp::NumericVector& extent, Rcpp::IntegerVector& dimension, bool nonzero);
+RcppExport SEXP _controlledburn_burn_polygon_checked(SEXP sfSEXP, SEXP extentSEXP, SEXP dimensionSEXP, SEXP nonzeroSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::DataFrame& >::type sf(sfSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector& >::type extent(extentSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector& >::type dimension(dimensionSEXP);
+    Rcpp::traits::input_parameter< bool >::type nonzero(nonzeroSEXP);
+    rcpp_result_gen = Rcpp::wrap(burn_polygon_checked(sf, extent, dimension, nonzero));
+    return rcpp_result_gen;
+END_RCPP
+}
 
 static const R_CallMethodDef CallEntries[] = {
-    {"_controlledburn_burn_polygon", (DL_FUNC) &_controlledburn_burn_polygon, 3},
+    {"_controlledburn_cell_area_rows", (DL_FUNC) &_controlledburn_cell_area_rows, 2},
+    {"_controlledburn_span_area", (DL_FUNC) &_controlledburn_span_area, 3},
+    {"_controlledburn_span_weighted_mean", (DL_FUNC) &_controlledburn_span_weighted_mean, 4},
+    {"_controlledburn_burn_polygon", (DL_FUNC) &_controlledburn_burn_polygon, 4},
     {"_controlledburn_burn_line", (DL_FUNC) &_controlledburn_burn_line, 3},
+    {"_controlledburn_burn_async_start", (DL_FUNC) &_controlledburn_burn_async_start, 3},
+    {"_controlledburn_burn_async_done", (DL_FUNC) &_controlledburn_burn_async_done, 1},
+    {"_controlledburn_burn_async_progress", (DL_FUNC) &_controlledburn_burn_async_progress, 1},
+    {"_controlledburn_burn_async_cancel", (DL_FUNC) &_controlledburn_burn_async_cancel, 1},
+    {"_controlledburn_burn_async_collect", (DL_FUNC) &_controlledburn_burn_async_collect, 1},
+    {"_controlledburn_burn_polygon_time", (DL_FUNC) &_controlledburn_burn_polygon_time, 6},
+    {"_controlledburn_materialize_cube", (DL_FUNC) &_controlledburn_materialize_cube, 3},
+    {"_controlledburn_cube_slice", (DL_FUNC) &_controlledburn_cube_slice, 2},
+    {"_controlledburn_burn_polygon_z", (DL_FUNC) &_controlledburn_burn_polygon_z, 6},
+    {"_controlledburn_burn_polygon_processes", (DL_FUNC) &_controlledburn_burn_polygon_processes, 7},
+    {"_controlledburn_engine_list_edges", (DL_FUNC) &_controlledburn_engine_list_edges, 1},
+    {"_controlledburn_burn_calibrate", (DL_FUNC) &_controlledburn_burn_calibrate, 1},
+    {"_controlledburn_point_density", (DL_FUNC) &_controlledburn_point_density, 7},
+    {"_controlledburn_disaggregate", (DL_FUNC) &_controlledburn_disaggregate, 5},
+    {"_controlledburn_burn_polygon_dissolve", (DL_FUNC) &_controlledburn_burn_polygon_dissolve, 4},
+    {"_controlledburn_extract_line", (DL_FUNC) &_controlledburn_extract_line, 5},
+    {"_controlledburn_focal_coverage", (DL_FUNC) &_controlledburn_focal_coverage, 5},
+    {"_controlledburn_extract_mosaic", (DL_FUNC) &_controlledburn_extract_mosaic, 6},
+    {"_controlledburn_mosaic_cache_info", (DL_FUNC) &_controlledburn_mosaic_cache_info, 0},
+    {"_controlledburn_burn_polygon_oriented", (DL_FUNC) &_controlledburn_burn_polygon_oriented, 5},
+    {"_controlledburn_materialize_oriented", (DL_FUNC) &_controlledburn_materialize_oriented, 3},
+    {"_controlledburn_plan_row_bands", (DL_FUNC) &_controlledburn_plan_row_bands, 4},
+    {"_controlledburn_burn_polygon_part", (DL_FUNC) &_controlledburn_burn_polygon_part, 6},
+    {"_controlledburn_merge_spanfiles", (DL_FUNC) &_controlledburn_merge_spanfiles, 2},
+    {"_controlledburn_merge_span_lists", (DL_FUNC) &_controlledburn_merge_span_lists, 1},
+    {"_controlledburn_burn_wkb_pipeline", (DL_FUNC) &_controlledburn_burn_wkb_pipeline, 6},
+    {"_controlledburn_pool_inline_cost", (DL_FUNC) &_controlledburn_pool_inline_cost, 1},
+    {"_controlledburn_pool_selftest", (DL_FUNC) &_controlledburn_pool_selftest, 3},
+    {"_controlledburn_burn_polygon_refine", (DL_FUNC) &_controlledburn_burn_polygon_refine, 5},
+    {"_controlledburn_span_reindex", (DL_FUNC) &_controlledburn_span_reindex, 5},
+    {"_controlledburn_simd_info", (DL_FUNC) &_controlledburn_simd_info, 0},
+    {"_controlledburn_read_spanfile", (DL_FUNC) &_controlledburn_read_spanfile, 1},
+    {"_controlledburn_burn_polygon_sorted", (DL_FUNC) &_controlledburn_burn_polygon_sorted, 5},
+    {"_controlledburn_burn_stream", (DL_FUNC) &_controlledburn_burn_stream, 7},
+    {"_controlledburn_tile_cover", (DL_FUNC) &_controlledburn_tile_cover, 2},
+    {"_controlledburn_trace_enabled", (DL_FUNC) &_controlledburn_trace_enabled, 0},
+    {"_controlledburn_trace_write", (DL_FUNC) &_controlledburn_trace_write, 1},
+    {"_controlledburn_burn_polygon_trapezoids", (DL_FUNC) &_controlledburn_burn_polygon_trapezoids, 3},
+    {"_controlledburn_trapezoid_spans", (DL_FUNC) &_controlledburn_trapezoid_spans, 4},
+    {"_controlledburn_burn_polygon_checked", (DL_FUNC) &_controlledburn_burn_polygon_checked, 4},
     {NULL, NULL, 0}
 };
 
@@ -0,0 +1,134 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "edge.h"
+#include "span.h"
+#include "area.h"
+#include "simd.h"
+
+// Cell area on longitude/latitude grids
+//
+// Every cell in a row has the same area on the ellipsoid, so areas come from
+// a table with one entry per row and a span weighs span_length * row_area.
+// The area between two parallels over dlambda radians of longitude is
+//   A = b^2 dlambda / 2 * [f(phi2) - f(phi1)],
+//   f(phi) = sin(phi) / (1 - e^2 sin^2(phi)) + 1/(2e) ln((1 + e sin(phi)) / (1 - e sin(phi)))
+
+inline double authalic_f(double phi, double e) {
+  double s = std::sin(phi);
+  return s / (1.0 - e * e * s * s) + std::log((1.0 + e * s) / (1.0 - e * s)) / (2.0 * e);
+}
+
+// Area in km^2 of a cell in each row of a longitude/latitude grid, top row first
+void ellipsoid_row_areas(RasterInfo &ras, std::vector<double> &areas) {
+  if (ras.ymin < -90.0 || ras.ymax > 90.0) Rcpp::stop("extent is not longitude/latitude");
+  double b = WGS84_A * (1.0 - WGS84_F);
+  double e = std::sqrt(WGS84_F * (2.0 - WGS84_F));
+  double dlambda = ras.xres * M_PI / 180.0;
+  areas.resize(ras.nrow);
+  double f1 = authalic_f(ras.ymax * M_PI / 180.0, e);
+  for (unsigned int r = 0; r < ras.nrow; r++) {
+    double f2 = authalic_f((ras.ymax - (r + 1) * ras.yres) * M_PI / 180.0, e);
+    areas[r] = b * b * dlambda / 2.0 * (f1 - f2);
+    f1 = f2;
+  }
+}
+
+// Number of features in an index, one more than the largest poly_id
+size_t index_nfeature(std::vector<const int *> &records, int id_field) {
+  int n = 0;
+  for (size_t i = 0; i < records.size(); i++) n = std::max(n, records[i][id_field] + 1);
+  return n;
+}
+
+// Stop unless a record (xstart, xend, row, poly_id) lies on the grid
+static void check_area_record(const int *rec, const RasterInfo &ras) {
+  if (rec[0] < 0 || rec[1] >= (int)ras.ncol || rec[2] < 0 || rec[2] >= (int)ras.nrow) {
+    Rcpp::stop("index record outside dimension");
+  }
+  if (rec[3] < 0) Rcpp::stop("poly_id must not be negative");
+}
+
+// Cell area of each row of a longitude/latitude grid
+//
+// @param extent numeric vector c(xmin, xmax, ymin , ymax) in degrees
+// @param dimension integer vector c(ncol, nrow)
+// @return numeric vector of nrow cell areas in km^2 on the WGS84 ellipsoid,
+// top row first
+// [[Rcpp::export]]
+Rcpp::NumericVector cell_area_rows(Rcpp::NumericVector &extent,
+                                   Rcpp::IntegerVector &dimension) {
+  RasterInfo ras(extent, dimension);
+  std::vector<double> areas;
+  ellipsoid_row_areas(ras, areas);
+  return Rcpp::wrap(areas);
+}
+
+// Area of each feature of an index on a longitude/latitude grid
+//
+// @param index list of records (xstart, xend, row, poly_id) from burn_polygon()
+// @param extent numeric vector c(xmin, xmax, ymin , ymax) in degrees
+// @param dimension integer vector c(ncol, nrow)
+// @return numeric vector of km^2 by poly_id (zero-based id i at position
+// i + 1), up to the largest poly_id in the index
+// [[Rcpp::export]]
+Rcpp::NumericVector span_area(Rcpp::List &index,
+                              Rcpp::NumericVector &extent,
+                              Rcpp::IntegerVector &dimension) {
+  RasterInfo ras(extent, dimension);
+  std::vector<double> areas;
+  ellipsoid_row_areas(ras, areas);
+  std::vector<const int *> records;
+  index_records(index, 4, records);
+
+  Rcpp::NumericVector out(index_nfeature(records, 3));
+  for (size_t i = 0; i < records.size(); i++) {
+    const int *rec = records[i];
+    check_area_record(rec, ras);
+    if (rec[1] < rec[0]) continue;
+    out[rec[3]] += (rec[1] - rec[0] + 1) * areas[rec[2]];
+  }
+  return out;
+}
+
+// Area-weighted mean of cell values by feature on a longitude/latitude grid
+//
+// Missing values are left out of both the sum and the area.
+//
+// @param index list of records (xstart, xend, row, poly_id) from burn_polygon()
+// @param extent numeric vector c(xmin, xmax, ymin , ymax) in degrees
+// @param dimension integer vector c(ncol, nrow)
+// @param values numeric vector of ncol * nrow cell values, row by row from the
+// top left as materialized
+// @return numeric vector of means by poly_id as in span_area(), NA for a
+// feature with no valued cells
+// [[Rcpp::export]]
+Rcpp::NumericVector span_weighted_mean(Rcpp::List &index,
+                                       Rcpp::NumericVector &extent,
+                                       Rcpp::IntegerVector &dimension,
+                                       Rcpp::NumericVector &values) {
+  RasterInfo ras(extent, dimension);
+  if (values.size() != (R_xlen_t)ras.ncol * ras.nrow) Rcpp::stop("values must have ncol * nrow elements");
+  std::vector<double> areas;
+  ellipsoid_row_areas(ras, areas);
+  std::vector<const int *> records;
+  index_records(index, 4, records);
+
+  size_t n = index_nfeature(records, 3);
+  std::vector<double> sum(n, 0.0), weight(n, 0.0);
+  const double *v = values.begin();
+  const SimdKernels &simd = simd_kernels();
+  for (size_t i = 0; i < records.size(); i++) {
+    const int *rec = records[i];
+    check_area_record(rec, ras);
+    if (rec[0] > rec[1]) continue;
+    double s = 0.0, count = 0.0, lo = R_PosInf, hi = R_NegInf;
+    simd.span_stats(v + (R_xlen_t)rec[2] * ras.ncol + rec[0], rec[1] - rec[0] + 1, &count, &s, &lo, &hi);
+    sum[rec[3]] += s * areas[rec[2]];
+    weight[rec[3]] += count * areas[rec[2]];
+  }
+  Rcpp::NumericVector out(n);
+  for (size_t i = 0; i < n; i++) {
+    out[i] = (weight[i] > 0) ? sum[i] / weight[i] : NA_REAL;
+  }
+  return out;
+}
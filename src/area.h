@@ -0,0 +1,14 @@
+#ifndef AREA
+#define AREA
+
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "edge.h"
+
+// WGS84 ellipsoid, km
+#define WGS84_A 6378.137
+#define WGS84_F (1.0/298.257223563)
+
+extern void ellipsoid_row_areas(RasterInfo &ras, std::vector<double> &areas);
+
+#endif
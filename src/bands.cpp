@@ -0,0 +1,78 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "bands.h"
+
+RowBands::RowBands(const std::vector<unsigned int> &row_breaks, unsigned int nrow) :
+  breaks(row_breaks), band_of_row(nrow) {
+  for (size_t b = 0; b + 1 < breaks.size(); b++) {
+    for (unsigned int r = breaks[b]; r < breaks[b + 1]; r++) band_of_row[r] = b;
+  }
+}
+
+void equal_row_bands(unsigned int nrow, size_t nband, std::vector<unsigned int> &breaks) {
+  nband = std::max(std::min(nband, (size_t)nrow), (size_t)1);
+  breaks.resize(nband + 1);
+  for (size_t b = 0; b <= nband; b++) breaks[b] = (uint64_t)nrow * b / nband;
+}
+
+void check_row_breaks(const std::vector<unsigned int> &breaks, unsigned int nrow) {
+  if (breaks.size() < 2 || breaks.front() != 0 || breaks.back() != nrow) {
+    Rcpp::stop("row breaks must run from 0 to nrow");
+  }
+  for (size_t b = 0; b + 1 < breaks.size(); b++) {
+    if (breaks[b] >= breaks[b + 1]) Rcpp::stop("row breaks must be increasing");
+  }
+}
+
+void feature_rows(const Feature &feature, RasterInfo &ras,
+                  unsigned int &top, unsigned int &bottom) {
+  double ymin = R_PosInf, ymax = R_NegInf;
+  for(Feature::const_iterator ring = feature.begin(); ring != feature.end(); ++ring) {
+    for(size_t i = 0; i < (*ring).y.size(); i++) {
+      ymin = std::min(ymin, (*ring).y[i]);
+      ymax = std::max(ymax, (*ring).y[i]);
+    }
+  }
+  double r0 = std::floor((ras.ymax - ymax) / ras.yres) - 1;
+  double r1 = std::ceil((ras.ymax - ymin) / ras.yres) + 1;
+  top = (unsigned int)std::min(std::max(r0, 0.0), (double)ras.nrow);
+  bottom = (unsigned int)std::min(std::max(r1, 0.0), (double)ras.nrow - 1);
+}
+
+void burn_bands(const std::vector<Feature> &features, RasterInfo &ras,
+                const RowBands &bands, const std::vector<bool> &own,
+                std::vector< std::vector<Span> > &band_spans, uint64_t *counts) {
+  size_t nband = bands.size();
+  band_spans.resize(nband);
+  std::vector<Span> spans;
+  for (size_t f = 0; f < features.size(); f++) {
+    unsigned int top, bottom;
+    feature_rows(features[f], ras, top, bottom);
+    if (top > bottom) continue;
+    //sweep each run of owned bands the feature reaches, and only its rows
+    unsigned int last = bands.band_of_row[bottom];
+    for (unsigned int b = bands.band_of_row[top]; b <= last; b++) {
+      if (!own[b]) continue;
+      unsigned int e = b;
+      while (e < last && own[e + 1]) e++;
+      spans.clear();
+      rasterize_feature(features[f], ras, spans, f, ENGINE_AUTO, bands.breaks[b], bands.breaks[e + 1]);
+      for (size_t i = 0; i < spans.size(); i++) {
+        unsigned int band = bands.band_of_row[spans[i].row];
+        band_spans[band].push_back(spans[i]);
+        counts[f * nband + band]++;
+      }
+      b = e;
+    }
+  }
+}
+
+uint64_t band_offsets(uint64_t *counts, size_t nfeature, size_t nband) {
+  uint64_t offset = 0;
+  for (size_t i = 0; i < nfeature * nband; i++) {
+    uint64_t n = counts[i];
+    counts[i] = offset;
+    offset += n;
+  }
+  return offset;
+}
@@ -0,0 +1,39 @@
+#ifndef ROW_BANDS
+#define ROW_BANDS
+
+#include "rasterize.h"
+#include <stdint.h>
+
+// Rows of a grid cut into bands, band b is rows [breaks[b], breaks[b + 1])
+//
+// Spans of the bands are laid out feature-major, all bands of feature 0 then
+// all of feature 1 and so on, which is the order burn_polygon() gives, so
+// bands burned apart merge into the same index from offsets alone.
+struct RowBands {
+  std::vector<unsigned int> breaks;
+  std::vector<unsigned int> band_of_row;
+
+  RowBands(const std::vector<unsigned int> &row_breaks, unsigned int nrow);
+  size_t size() const { return breaks.size() - 1; }
+};
+
+extern void equal_row_bands(unsigned int nrow, size_t nband, std::vector<unsigned int> &breaks);
+extern void check_row_breaks(const std::vector<unsigned int> &breaks, unsigned int nrow);
+
+// Rows a feature may cover, a little generous
+extern void feature_rows(const Feature &feature, RasterInfo &ras,
+                         unsigned int &top, unsigned int &bottom);
+
+// Sweep the rows of the bands marked in own for every feature reaching them,
+// appending the spans to band_spans of their band in feature order and
+// counting them in counts[feature * nband + band]; a feature is swept once
+// per run of neighbouring owned bands, over those rows only. Runs without
+// the R API or the task pool
+extern void burn_bands(const std::vector<Feature> &features, RasterInfo &ras,
+                       const RowBands &bands, const std::vector<bool> &own,
+                       std::vector< std::vector<Span> > &band_spans, uint64_t *counts);
+
+// Turn counts by (feature, band) into feature-major offsets, returning the total
+extern uint64_t band_offsets(uint64_t *counts, size_t nfeature, size_t nband);
+
+#endif
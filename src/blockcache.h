@@ -0,0 +1,86 @@
+#ifndef BLOCK_CACHE
+#define BLOCK_CACHE
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Shared least recently used cache of decoded raster blocks
+//
+// Blocks are kept by key for the session, so later calls reading the same
+// block files find them decoded. Lookups are under one mutex but loading is
+// not, so threads decode different blocks at the same time; if two load the
+// same block the first one stored wins. Blocks are handed out as shared
+// pointers, so one evicted while in use stays valid for whoever holds it.
+class BlockCache {
+public:
+  typedef std::vector<double> Block;
+  typedef std::shared_ptr<const Block> BlockPtr;
+  typedef std::function<void(Block &)> Loader;
+
+  BlockCache() : capacity_(0), bytes_(0), loads_(0) {}
+
+  BlockPtr get(const std::string &key, const Loader &loader) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      Map::iterator it = map_.find(key);
+      if (it != map_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return it->second->second;
+      }
+    }
+    std::shared_ptr<Block> block(new Block());
+    loader(*block);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    loads_++;
+    Map::iterator it = map_.find(key);
+    if (it != map_.end()) {
+      lru_.splice(lru_.begin(), lru_, it->second);
+      return it->second->second;
+    }
+    lru_.push_front(Entry(key, block));
+    map_[key] = lru_.begin();
+    bytes_ += block->size() * sizeof(double);
+    evict();
+    return block;
+  }
+
+  void set_capacity(size_t capacity_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity_bytes;
+    evict();
+  }
+
+  // Blocks held, their bytes and the blocks ever loaded
+  void usage(size_t &blocks, size_t &bytes, size_t &loads) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    blocks = lru_.size();
+    bytes = bytes_;
+    loads = loads_;
+  }
+
+private:
+  typedef std::pair<std::string, BlockPtr> Entry;
+  typedef std::unordered_map<std::string, std::list<Entry>::iterator> Map;
+
+  //always keep the newest block, even if it alone is over capacity
+  void evict() {
+    while (bytes_ > capacity_ && lru_.size() > 1) {
+      bytes_ -= lru_.back().second->size() * sizeof(double);
+      map_.erase(lru_.back().first);
+      lru_.pop_back();
+    }
+  }
+
+  size_t capacity_, bytes_, loads_;
+  std::mutex mutex_;
+  std::list<Entry> lru_;
+  Map map_;
+};
+
+#endif
@@ -26,6 +26,9 @@ using namespace Rcpp;
 // MULTIPOLYGON objects.
 // @param extent numeric vector c(xmin, xmax, ymin , ymax)
 // @param dimension integer vector c(ncol, nrow)
+// @param engine how to sweep each feature, "list", "table" or "auto" to pick
+// per feature from its edges per row, by a threshold measured on x86-64 or
+// by burn_calibrate() on this machine; all burn the same cells
 // @return nothing atm
 // @references Wylie, C., Romney, G., Evans, D., & Erdahl, A. (1967).
 //   Half-tone perspective drawings by computer. Proceedings of the November
@@ -34,28 +37,30 @@ using namespace Rcpp;
 // [[Rcpp::export]]
 Rcpp::List burn_polygon(Rcpp::DataFrame &sf,
                    Rcpp::NumericVector &extent,
-                   Rcpp::IntegerVector &dimension) {
+                   Rcpp::IntegerVector &dimension,
+                   std::string engine = "auto") {
 
+  PolygonEngine sweep = polygon_engine(engine);
   Rcpp::List polygons;
-  Rcpp::NumericVector field_vals;
   check_inputs_polygon(sf, polygons);  // Also fills in polygons
 
   //set up things we'll use later
-  Rcpp::List::iterator p;
-  Rcpp::NumericVector::iterator f;
   RasterInfo ras(extent, dimension);
-  CollectorList out_vector;
-    //Rasterize but always assign to the one layer
-    p = polygons.begin();
-    f = field_vals.begin();
-     for(; p != polygons.end(); ++p, ++f) {
-       rasterize_polygon( (*p), ras, out_vector, p.index());
-    }
-
-    return out_vector.vector();
-}
+  std::vector<Feature> features;
+  std::vector<Span> spans;
+  //Copy out of R so the features can be swept on the task pool
+  features_from_list(polygons, features);
+  rasterize_features(features, ras, spans, task_pool(), sweep);
 
+  return spans_to_list(spans);
+}
 
+// Rasterize lines
+//
+// There is no engine to choose here: the one alternative traversal in the
+// package, traverse_segment(), visits every cell a segment passes through,
+// which is a different set of cells from this stepping, so picking between
+// them per feature would change the result.
 // [[Rcpp::export]]
 Rcpp::List burn_line(Rcpp::DataFrame &sf,
                         Rcpp::NumericVector &extent,
@@ -0,0 +1,125 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "edge.h"
+#include "check_inputs.h"
+
+#include "geometry.h"
+#include "rasterize.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// A polygon burn running on a background thread
+//
+// The coordinates are copied into native rings before the thread starts, so
+// the sweep never touches R. Features are swept on the task pool from the
+// background thread, and the spans are handed back to R by collect() on the
+// main thread. Cancellation is checked between features.
+class BurnJob {
+public:
+  std::vector<Feature> features;
+  RasterInfo ras;
+  std::vector<Span> spans;
+  std::string error;
+  std::atomic<size_t> done;
+  std::atomic<bool> cancelled, finished;
+
+  BurnJob(RasterInfo &ras_) : ras(ras_), done(0), cancelled(false), finished(false) {}
+
+  ~BurnJob() {
+    cancelled = true;
+    if (worker.joinable()) worker.join();
+  }
+
+  void start() {
+    worker = std::thread(&BurnJob::run, this);
+  }
+
+  void join() {
+    if (worker.joinable()) worker.join();
+  }
+
+private:
+  std::thread worker;
+
+  void run() {
+    try {
+      std::vector< std::vector<Span> > parts(features.size());
+      double cost = 0;
+      for (size_t i = 0; i < features.size(); i++) cost += feature_cost(features[i], ras);
+      TaskPool::instance().parallel_for(features.size(), cost, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end && !cancelled; i++) {
+          rasterize_feature(features[i], ras, parts[i], i);
+          done++;
+        }
+      });
+      for (size_t i = 0; i < parts.size(); i++) {
+        spans.insert(spans.end(), parts[i].begin(), parts[i].end());
+      }
+    } catch (std::exception &e) {
+      error = e.what();
+    }
+    finished = true;
+  }
+};
+
+// Start a polygon burn on a background thread
+//
+// @param sf an [sf::sf()] object with a geometry column of POLYGON and/or
+// MULTIPOLYGON objects.
+// @param extent numeric vector c(xmin, xmax, ymin , ymax)
+// @param dimension integer vector c(ncol, nrow)
+// @return external pointer to the running job, see burn_async()
+// [[Rcpp::export]]
+SEXP burn_async_start(Rcpp::DataFrame &sf,
+                      Rcpp::NumericVector &extent,
+                      Rcpp::IntegerVector &dimension) {
+  Rcpp::List polygons;
+  check_inputs_polygon(sf, polygons);  // Also fills in polygons
+
+  RasterInfo ras(extent, dimension);
+  task_pool();  // size the pool from the R thread, the job runs on it
+  BurnJob *job = new BurnJob(ras);
+  Rcpp::XPtr<BurnJob> handle(job, true);
+  features_from_list(polygons, job->features);
+  job->start();
+  return handle;
+}
+
+// [[Rcpp::export]]
+bool burn_async_done(SEXP handle) {
+  Rcpp::XPtr<BurnJob> job(handle);
+  return job->finished;
+}
+
+// [[Rcpp::export]]
+double burn_async_progress(SEXP handle) {
+  Rcpp::XPtr<BurnJob> job(handle);
+  if (job->features.empty()) return 1.0;
+  return (double)job->done / job->features.size();
+}
+
+// [[Rcpp::export]]
+void burn_async_cancel(SEXP handle) {
+  Rcpp::XPtr<BurnJob> job(handle);
+  job->cancelled = true;
+}
+
+// Wait for a background burn and return its index
+//
+// Waiting polls for a user interrupt, which leaves the job running.
+// @return list of records (xstart, xend, row, poly_id) as from burn_polygon()
+// [[Rcpp::export]]
+Rcpp::List burn_async_collect(SEXP handle) {
+  Rcpp::XPtr<BurnJob> job(handle);
+  while (!job->finished) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    Rcpp::checkUserInterrupt();
+  }
+  job->join();
+  if (!job->error.empty()) Rcpp::stop(job->error);
+  if (job->cancelled && job->done < job->features.size()) Rcpp::stop("burn was cancelled");
+
+  return spans_to_list(job->spans);
+}
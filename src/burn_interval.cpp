@@ -0,0 +1,194 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "edge.h"
+#include "check_inputs.h"
+
+#include "edgelist.h"
+#include "rasterize.h"
+#include "simd.h"
+
+
+
+// Burn polygons that are each present over a range of layers of a cube
+//
+// Every polygon is rasterized once, its spans are stamped with the first and
+// last layer (zero-based, inclusive) it occupies, so a feature that persists
+// over many layers costs one sweep rather than one per layer. Features with
+// lev0 > lev1 occupy no layer and are not swept at all.
+//
+// Records are (xstart, xend, row, lev0, lev1, poly_id).
+void burn_polygon_layers(Rcpp::List &polygons, RasterInfo &ras,
+                         std::vector<int> &lev0, std::vector<int> &lev1,
+                         CollectorList &out_vector) {
+  std::vector<Feature> features;
+  std::vector<Span> spans;
+  features_from_list(polygons, features);
+  for (size_t i = 0; i < features.size(); i++) {
+    if (lev0[i] > lev1[i]) features[i].clear();
+  }
+  rasterize_features(features, ras, spans, task_pool());
+  for (std::vector<Span>::iterator sp = spans.begin(); sp != spans.end(); ++sp) {
+    unsigned int i = (*sp).poly_id;
+    out_vector.push_back(Rcpp::IntegerVector::create((*sp).xstart, (*sp).xend, (*sp).row,
+                                                     lev0[i], lev1[i], i));
+  }
+}
+
+// Rasterize polygons with a time interval into a (time, row, col) index
+//
+// @param sf an [sf::sf()] object with a geometry column of POLYGON and/or
+// MULTIPOLYGON objects.
+// @param extent numeric vector c(xmin, xmax, ymin , ymax)
+// @param dimension integer vector c(ncol, nrow)
+// @param start,end numeric (or Date, POSIXct) interval of each feature, NA
+// means the feature is never present
+// @param time increasing numeric time axis, a feature is present at step k
+// when start <= time[k] <= end
+// @return list of records (xstart, xend, row, t0, t1, poly_id) zero-based
+// [[Rcpp::export]]
+Rcpp::List burn_polygon_time(Rcpp::DataFrame &sf,
+                             Rcpp::NumericVector &extent,
+                             Rcpp::IntegerVector &dimension,
+                             Rcpp::NumericVector &start,
+                             Rcpp::NumericVector &end,
+                             Rcpp::NumericVector &time) {
+  Rcpp::List polygons;
+  check_inputs_polygon(sf, polygons);  // Also fills in polygons
+
+  if (start.size() != polygons.size() || end.size() != polygons.size()) {
+    Rcpp::stop("start and end must have one value per feature");
+  }
+  if (!std::is_sorted(time.begin(), time.end())) {
+    Rcpp::stop("time must be increasing");
+  }
+
+  std::vector<int> t0(polygons.size()), t1(polygons.size());
+  for (R_xlen_t i = 0; i < polygons.size(); i++) {
+    if (ISNAN(start[i]) || ISNAN(end[i])) {
+      t0[i] = 1;
+      t1[i] = 0;
+      continue;
+    }
+    t0[i] = std::lower_bound(time.begin(), time.end(), start[i]) - time.begin();
+    t1[i] = (std::upper_bound(time.begin(), time.end(), end[i]) - time.begin()) - 1;
+  }
+
+  RasterInfo ras(extent, dimension);
+  CollectorList out_vector;
+  burn_polygon_layers(polygons, ras, t0, t1, out_vector);
+  return out_vector.vector();
+}
+
+
+// Materialize a layered index as a count cube
+//
+// @param index list of records (xstart, xend, row, lev0, lev1, poly_id)
+// @param dimension integer vector c(ncol, nrow)
+// @param nlayer number of layers in the cube
+// @return integer array with dim c(ncol, nrow, nlayer) of the number of
+// features present in each cell
+// [[Rcpp::export]]
+Rcpp::IntegerVector materialize_cube(Rcpp::List &index,
+                                     Rcpp::IntegerVector &dimension,
+                                     int nlayer) {
+  R_xlen_t ncol = dimension[0], nrow = dimension[1];
+  R_xlen_t ncell = ncol * nrow;
+  if (nlayer < 0) Rcpp::stop("nlayer must not be negative");
+  Rcpp::IntegerVector out(ncell * nlayer);
+  std::vector<const int *> records;
+  index_records(index, 6, records);
+  for (size_t i = 0; i < records.size(); i++) {
+    const int *rec = records[i];
+    if (rec[0] < 0 || rec[1] >= ncol || rec[2] < 0 || rec[2] >= nrow) {
+      Rcpp::stop("index record outside dimension");
+    }
+    if (rec[3] < 0 || rec[4] < rec[3]) Rcpp::stop("index record layers must be 0 <= lev0 <= lev1");
+  }
+
+  //each task fills its own band of layers
+  const SimdKernels &simd = simd_kernels();
+  int *cube = out.begin();
+  double cost = (double)records.size() * nlayer;
+  task_pool().parallel_for(nlayer, cost, [&](size_t begin, size_t end) {
+    for (size_t i = 0; i < records.size(); i++) {
+      const int *rec = records[i];
+      int l0 = std::max(rec[3], (int)begin);
+      int l1 = std::min(rec[4], (int)end - 1);
+      for (int l = l0; l <= l1; l++) {
+        if (rec[1] >= rec[0]) simd.span_fill(cube + l * ncell + rec[2] * ncol + rec[0], rec[1] - rec[0] + 1);
+      }
+    }
+  });
+  out.attr("dim") = Rcpp::Dimension(ncol, nrow, nlayer);
+  return out;
+}
+
+// Extract the spans present in one layer of a layered index
+//
+// @param index list of records (xstart, xend, row, lev0, lev1, poly_id)
+// @param layer zero-based layer
+// @return list of records (xstart, xend, row, poly_id) as from burn_polygon()
+// [[Rcpp::export]]
+Rcpp::List cube_slice(Rcpp::List &index, int layer) {
+  CollectorList out_vector;
+  for (R_xlen_t i = 0; i < index.size(); i++) {
+    Rcpp::IntegerVector rec = index[i];
+    if (rec.size() < 6) Rcpp::stop("index records must be (xstart, xend, row, lev0, lev1, poly_id)");
+    if (rec[3] <= layer && layer <= rec[4]) {
+      out_vector.push_back(Rcpp::IntegerVector::create(rec[0], rec[1], rec[2], rec[5]));
+    }
+  }
+  return out_vector.vector();
+}
+
+// Voxelize extruded polygons into (level, row, col) column spans
+//
+// Levels are sampled at their centres like rows and columns, so level k is
+// occupied when zmin <= zgrid[1] + (k + 0.5) * zgrid[2] < zmax.
+//
+// @param sf an [sf::sf()] object with a geometry column of POLYGON and/or
+// MULTIPOLYGON objects.
+// @param extent numeric vector c(xmin, xmax, ymin , ymax)
+// @param dimension integer vector c(ncol, nrow)
+// @param zmin,zmax numeric base and top height of each feature
+// @param zgrid numeric vector c(zmin, zres, nlev) of the vertical grid
+// @return list of records (xstart, xend, row, lev0, lev1, poly_id) zero-based,
+// use materialize_cube() with nlayer = nlev for the 3D array
+// [[Rcpp::export]]
+Rcpp::List burn_polygon_z(Rcpp::DataFrame &sf,
+                          Rcpp::NumericVector &extent,
+                          Rcpp::IntegerVector &dimension,
+                          Rcpp::NumericVector &zmin,
+                          Rcpp::NumericVector &zmax,
+                          Rcpp::NumericVector &zgrid) {
+  Rcpp::List polygons;
+  check_inputs_polygon(sf, polygons);  // Also fills in polygons
+
+  if (zmin.size() != polygons.size() || zmax.size() != polygons.size()) {
+    Rcpp::stop("zmin and zmax must have one value per feature");
+  }
+  if (zgrid.size() != 3 || !(zgrid[1] > 0) || zgrid[2] < 1) {
+    Rcpp::stop("zgrid must be c(zmin, zres, nlev) with positive zres and nlev");
+  }
+  double z0 = zgrid[0], zres = zgrid[1];
+  int nlev = zgrid[2];
+
+  std::vector<int> lev0(polygons.size()), lev1(polygons.size());
+  for (R_xlen_t i = 0; i < polygons.size(); i++) {
+    if (ISNAN(zmin[i]) || ISNAN(zmax[i])) {
+      lev0[i] = 1;
+      lev1[i] = 0;
+      continue;
+    }
+    //Convert to level space the same way rows are, first and last centre covered
+    double l0 = std::ceil((zmin[i] - z0)/zres - 0.5);
+    double l1 = std::ceil((zmax[i] - z0)/zres - 0.5) - 1;
+    lev0[i] = std::max(l0, 0.0);
+    lev1[i] = std::min(l1, nlev - 1.0);
+  }
+
+  RasterInfo ras(extent, dimension);
+  CollectorList out_vector;
+  burn_polygon_layers(polygons, ras, lev0, lev1, out_vector);
+  return out_vector.vector();
+}
@@ -0,0 +1,227 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "edge.h"
+#include "check_inputs.h"
+
+#include "bands.h"
+#include "spanfile.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+// Multi-process burn into a shared span file
+//
+// The grid is cut into row bands and each forked worker process takes a run
+// of neighbouring bands. Workers see the features the parent copied out of
+// R through copy-on-write pages, with nothing serialized. Each sweeps the
+// rows of its bands for the features reaching them, so a large feature is
+// split between the workers rather than swept by each, and counts its spans
+// by feature and band into a shared anonymous map. Once all have counted,
+// the parent turns the counts into feature-major offsets, sizes the span
+// file and lets the workers go, and each copies its records straight into
+// its place in the shared file mapping. The file is then the same index
+// burn_polygon() returns. With one worker, or without fork (on Windows),
+// the bands run on the task pool in this process instead.
+
+// Copy the spans of each band to their offsets in the records of a span file
+void write_band_spans(const std::vector< std::vector<Span> > &band_spans,
+                      const uint64_t *offsets, unsigned char *records) {
+  size_t nband = band_spans.size();
+  for (size_t b = 0; b < nband; b++) {
+    const std::vector<Span> &spans = band_spans[b];
+    uint64_t at = 0;
+    long feature = -1;
+    for (size_t i = 0; i < spans.size(); i++) {
+      if ((long)spans[i].poly_id != feature) {
+        feature = spans[i].poly_id;
+        at = offsets[feature * nband + b];
+      }
+      int32_t rec[4] = {(int32_t)spans[i].xstart, (int32_t)spans[i].xend,
+                        (int32_t)spans[i].row, (int32_t)spans[i].poly_id};
+      std::memcpy(records + at * SPANFILE_RECORD, rec, SPANFILE_RECORD);
+      at++;
+    }
+  }
+}
+
+// Burn the bands on the task pool in this process and write the span file
+void burn_bands_pool(const std::vector<Feature> &features, RasterInfo &ras,
+                     const RowBands &bands, const std::string &path) {
+  size_t nband = bands.size();
+  std::vector<uint64_t> counts(features.size() * nband, 0);
+  std::vector< std::vector<Span> > band_spans(nband);
+  double cost = 0;
+  for (size_t i = 0; i < features.size(); i++) cost += feature_cost(features[i], ras);
+  task_pool().parallel_for(nband, cost, [&](size_t begin, size_t end) {
+    std::vector<bool> own(nband, false);
+    for (size_t b = begin; b < end; b++) own[b] = true;
+    std::vector< std::vector<Span> > mine;
+    burn_bands(features, ras, bands, own, mine, counts.data());
+    for (size_t b = begin; b < end; b++) band_spans[b].swap(mine[b]);
+  });
+  uint64_t total = band_offsets(counts.data(), features.size(), nband);
+  std::vector<unsigned char> records(total * SPANFILE_RECORD);
+  write_band_spans(band_spans, counts.data(), records.data());
+
+  unsigned char header[SPANFILE_HEADER];
+  write_spanfile_header(header, ras.ncol, ras.nrow, total);
+  FILE *file = std::fopen(path.c_str(), "wb");
+  if (file == NULL) Rcpp::stop("cannot open span file for writing");
+  bool ok = std::fwrite(header, 1, SPANFILE_HEADER, file) == SPANFILE_HEADER &&
+    std::fwrite(records.data(), 1, records.size(), file) == records.size();
+  ok = (std::fclose(file) == 0) && ok;
+  if (!ok) Rcpp::stop("failed writing span file");
+}
+
+#ifdef _WIN32
+
+void burn_bands_workers(const std::vector<Feature> &features, RasterInfo &ras,
+                        const RowBands &bands, int /*workers*/, const std::string &path) {
+  burn_bands_pool(features, ras, bands, path);
+}
+
+#else
+
+// One forked worker: count, wait for the offsets, write
+static int band_worker(const std::vector<Feature> &features, RasterInfo &ras,
+                       const RowBands &bands, int worker, int workers,
+                       uint64_t *counts, int ready, int go, int fd) {
+  try {
+    size_t nband = bands.size();
+    std::vector<bool> own(nband, false);
+    for (size_t b = nband * worker / workers; b < nband * (worker + 1) / workers; b++) own[b] = true;
+    std::vector< std::vector<Span> > band_spans;
+    burn_bands(features, ras, bands, own, band_spans, counts);
+
+    char c = 1;
+    if (write(ready, &c, 1) != 1) return 1;
+    close(ready);
+    if (read(go, &c, 1) != 1) return 1;  //the parent gave up
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) return 1;
+    if ((size_t)st.st_size <= SPANFILE_HEADER) return 0;
+    void *view = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) return 1;
+    write_band_spans(band_spans, counts, (unsigned char *)view + SPANFILE_HEADER);
+    return munmap(view, st.st_size) == 0 ? 0 : 1;
+  } catch (...) {
+    return 1;
+  }
+}
+
+void burn_bands_workers(const std::vector<Feature> &features, RasterInfo &ras,
+                        const RowBands &bands, int workers, const std::string &path) {
+  if (workers == 1) {
+    burn_bands_pool(features, ras, bands, path);
+    return;
+  }
+  size_t nband = bands.size();
+  size_t ncount = std::max(features.size() * nband, (size_t)1);
+  void *shared = mmap(NULL, ncount * sizeof(uint64_t), PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (shared == MAP_FAILED) Rcpp::stop("cannot map shared counts");
+  uint64_t *counts = (uint64_t *)shared;
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  int ready[2], go[2];
+  if (fd < 0 || pipe(ready) != 0 || pipe(go) != 0) {
+    munmap(shared, ncount * sizeof(uint64_t));
+    if (fd >= 0) close(fd);
+    Rcpp::stop("cannot set up workers");
+  }
+
+  std::vector<pid_t> pids;
+  for (int w = 0; w < workers; w++) {
+    pid_t pid = fork();
+    if (pid == 0) {
+      close(ready[0]);
+      close(go[1]);
+      _exit(band_worker(features, ras, bands, w, workers, counts, ready[1], go[0], fd));
+    }
+    if (pid < 0) break;
+    pids.push_back(pid);
+  }
+  close(ready[1]);
+  close(go[0]);
+
+  //every worker signals once counted, or closes the pipe by dying
+  size_t counted = 0;
+  char c;
+  while (counted < pids.size() && read(ready[0], &c, 1) == 1) counted++;
+  close(ready[0]);
+  bool ok = pids.size() == (size_t)workers && counted == pids.size();
+  uint64_t total = 0;
+  if (ok) {
+    total = band_offsets(counts, features.size(), nband);
+    unsigned char header[SPANFILE_HEADER];
+    write_spanfile_header(header, ras.ncol, ras.nrow, total);
+    ok = ftruncate(fd, SPANFILE_HEADER + total * SPANFILE_RECORD) == 0 &&
+      pwrite(fd, header, SPANFILE_HEADER, 0) == SPANFILE_HEADER;
+  }
+  if (ok) {
+    //a failed write if every worker died, rather than SIGPIPE for the session
+    void (*pipe_handler)(int) = signal(SIGPIPE, SIG_IGN);
+    std::vector<char> start(pids.size(), 1);
+    ok = write(go[1], start.data(), start.size()) == (ssize_t)start.size();
+    signal(SIGPIPE, pipe_handler);
+  }
+  close(go[1]);  //workers still waiting read the end and stop
+
+  for (size_t i = 0; i < pids.size(); i++) {
+    int status;
+    if (waitpid(pids[i], &status, 0) != pids[i] || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      ok = false;
+    }
+  }
+  munmap(shared, ncount * sizeof(uint64_t));
+  ok = (close(fd) == 0) && ok;
+  if (!ok) Rcpp::stop("a burn worker failed");
+}
+
+#endif
+
+// Rasterize polygons in worker processes into one span file
+//
+// @param sf an [sf::sf()] object with a geometry column of POLYGON and/or
+// MULTIPOLYGON objects.
+// @param extent numeric vector c(xmin, xmax, ymin , ymax)
+// @param dimension integer vector c(ncol, nrow)
+// @param path span file to write (see read_spanfile())
+// @param workers number of worker processes, each burning a run of
+// neighbouring bands
+// @param bands number of row bands of equal height, 0 for four per worker
+// @param breaks optional integer row breaks from plan_row_bands(), used in
+// place of equal bands
+// @return path, the spans in the order of burn_polygon()
+// [[Rcpp::export]]
+std::string burn_polygon_processes(Rcpp::DataFrame &sf,
+                                   Rcpp::NumericVector &extent,
+                                   Rcpp::IntegerVector &dimension,
+                                   std::string path,
+                                   int workers = 2,
+                                   int bands = 0,
+                                   SEXP breaks = R_NilValue) {
+  Rcpp::List polygons;
+  check_inputs_polygon(sf, polygons);  // Also fills in polygons
+  if (workers < 1) Rcpp::stop("workers must be at least 1");
+  RasterInfo ras(extent, dimension);
+  std::vector<unsigned int> row_breaks;
+  if (Rf_isNull(breaks)) {
+    equal_row_bands(ras.nrow, bands > 0 ? bands : 4 * workers, row_breaks);
+  } else {
+    Rcpp::IntegerVector given(breaks);
+    row_breaks.assign(given.begin(), given.end());
+    check_row_breaks(row_breaks, ras.nrow);
+  }
+
+  std::vector<Feature> features;
+  features_from_list(polygons, features);
+  burn_bands_workers(features, ras, RowBands(row_breaks, ras.nrow), workers, path);
+  return path;
+}
@@ -0,0 +1,124 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "edge.h"
+
+#include "edgelist.h"
+#include "rasterize.h"
+
+#include <chrono>
+#include <random>
+
+// Calibration of engine = "auto"
+//
+// Thresholds depend on the machine, so they are measured on it. The table
+// engine's insertion sort is close to linear while few edges join the
+// active set per row, and grows with the active edges times the edges
+// joining once many do, where the list's full sort wins. Rings through
+// scattered points, with a growing number of edges per row, are swept by
+// both engines, and the list engine takes over from the smallest number of
+// edges per row from which it is faster throughout. The pool's inline_cost,
+// the work below which parallel_for() runs on the caller, is set from the
+// cost of handing out a round of empty tasks in units of sweep work.
+//
+// The thread count is not tuned: it is the share of the machine the session
+// may use, set with options(controlledburn.threads) or the environment, and
+// inline_cost already keeps work too small to gain from threads on one.
+
+// A ring through n points scattered over the unit square, the same points
+// on every machine
+static void scatter_feature(int n, Feature &feature) {
+  std::mt19937 generator(n);
+  std::uniform_real_distribution<double> unit(0, 1);
+  Ring ring;
+  for (int i = 0; i < n; i++) {
+    ring.x.push_back(unit(generator));
+    ring.y.push_back(unit(generator));
+  }
+  ring.x.push_back(ring.x[0]);
+  ring.y.push_back(ring.y[0]);
+  feature.clear();
+  feature.push_back(ring);
+}
+
+// Seconds per sweep of a feature by one engine, over enough runs to time
+static double time_engine(const Feature &feature, RasterInfo &ras, PolygonEngine engine) {
+  typedef std::chrono::steady_clock clock;
+  std::vector<Span> spans;
+  size_t runs = 0;
+  clock::time_point start = clock::now();
+  double elapsed = 0;
+  while (elapsed < 0.02 || runs < 3) {
+    spans.clear();
+    rasterize_feature(feature, ras, spans, 0, engine);
+    runs++;
+    elapsed = std::chrono::duration<double>(clock::now() - start).count();
+  }
+  return elapsed / runs;
+}
+
+// Set the edges per row from which engine = "auto" uses the list
+//
+// @param edges mean edges starting per row of a feature, or NULL to leave
+// it; 0 picks the list for every feature, Inf the table
+// @return the previous setting
+// [[Rcpp::export]]
+double engine_list_edges(SEXP edges = R_NilValue) {
+  EngineTuning &tuning = engine_tuning();
+  double old = tuning.list_edges;
+  if (!Rf_isNull(edges)) tuning.list_edges = Rf_asReal(edges);
+  return old;
+}
+
+// Calibrate engine selection for this machine
+//
+// Sweeps synthetic features with each engine and sets the thresholds used by
+// burn_polygon(engine = "auto") for the rest of the session.
+//
+// @param dimension integer vector c(ncol, nrow) of the grid to time on
+// @return list with list_edges, the mean edges per row from which the list
+// engine is used, inline_cost, the pool's threshold for running work on the
+// calling thread, and timings, a data frame of seconds per feature by each
+// engine against edges per row
+// [[Rcpp::export]]
+Rcpp::List burn_calibrate(Rcpp::IntegerVector dimension = Rcpp::IntegerVector::create(100, 100)) {
+  Rcpp::NumericVector extent = Rcpp::NumericVector::create(0, 1, 0, 1);
+  RasterInfo ras(extent, dimension);
+  const int per_row[] = {1, 2, 4, 8, 16, 32, 64, 128, 256};
+  const int ncase = sizeof(per_row) / sizeof(per_row[0]);
+  std::vector<double> edges(ncase), list_time(ncase), table_time(ncase);
+  Feature feature;
+  for (int i = 0; i < ncase; i++) {
+    scatter_feature(per_row[i] * ras.nrow, feature);
+    edges[i] = per_row[i];
+    list_time[i] = time_engine(feature, ras, ENGINE_LIST);
+    table_time[i] = time_engine(feature, ras, ENGINE_TABLE);
+  }
+  //from the case after the last the table wins, or from the first if it never does
+  double list_edges = edges[0];
+  for (int i = 0; i < ncase; i++) {
+    if (table_time[i] <= list_time[i]) {
+      list_edges = (i + 1 < ncase) ? edges[i + 1] : R_PosInf;
+    }
+  }
+  engine_tuning().list_edges = list_edges;
+
+  //the work one round of task hand-off costs, in feature_cost() units
+  scatter_feature(ras.nrow, feature);
+  double unit = table_time[0] / feature_cost(feature, ras);
+  TaskPool &pool = task_pool();
+  typedef std::chrono::steady_clock clock;
+  int rounds = 200;
+  clock::time_point start = clock::now();
+  for (int r = 0; r < rounds; r++) {
+    pool.parallel_for(pool.size() * 4, R_PosInf, [](size_t, size_t) {});
+  }
+  double handoff = std::chrono::duration<double>(clock::now() - start).count() / rounds;
+  if (pool.size() > 1) pool.set_inline_cost(4 * handoff / unit);
+
+  return Rcpp::List::create(Rcpp::Named("list_edges") = list_edges,
+                            Rcpp::Named("inline_cost") = pool.inline_cost(),
+                            Rcpp::Named("timings") = Rcpp::DataFrame::create(
+                              Rcpp::Named("edges") = Rcpp::wrap(edges),
+                              Rcpp::Named("list") = Rcpp::wrap(list_time),
+                              Rcpp::Named("table") = Rcpp::wrap(table_time)));
+}
@@ -49,3 +49,33 @@ void check_inputs_line(Rcpp::DataFrame &sf,
     Rcpp::stop(err);
   }
 }
+
+
+// Accepts either polygons or lines, returns true when the geometry is polygonal
+bool check_inputs_polygon_or_line(Rcpp::DataFrame &sf,
+                                  Rcpp::List &geometries) {
+
+  std::stringstream err_msg;
+
+  if(!Rf_inherits(sf, "sf")) {
+    err_msg << "sf must be of class sf." << std::endl;
+  }
+
+  geometries = sf[Rcpp::as<std::string>(sf.attr("sf_column"))];
+
+  bool polygonal = Rf_inherits(geometries, "sfc_MULTIPOLYGON") |
+    Rf_inherits(geometries, "sfc_POLYGON");
+  if(!(polygonal |
+     Rf_inherits(geometries, "sfc_MULTILINESTRING") |
+     Rf_inherits(geometries, "sfc_LINESTRING"))) {
+    err_msg << "sf geometry must be POLYGON, MULTIPOLYGON, LINESTRING or MULTILINESTRING" << std::endl;
+  }
+
+
+
+  std::string err = err_msg.str();
+  if(!err.empty()) {
+    Rcpp::stop(err);
+  }
+  return polygonal;
+}
@@ -8,5 +8,8 @@ extern void check_inputs_polygon(Rcpp::DataFrame &sf,
 extern void check_inputs_line(Rcpp::DataFrame &sf,
                                  Rcpp::List &lines);
 
+extern bool check_inputs_polygon_or_line(Rcpp::DataFrame &sf,
+                                         Rcpp::List &geometries);
+
 
 #endif
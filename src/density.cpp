@@ -0,0 +1,172 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "edge.h"
+#include "pool.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Point kernel density
+//
+// Every point places a kernel of radius r on the grid. On each row the cells
+// within r of the point are a single run found analytically from the disc,
+// so only cells with weight are visited. Squared column distances (and for
+// the Gaussian its column factor) are computed once per point and reused on
+// every row, leaving a plain multiply-add over the run. The grid is cut into
+// row bands on the task pool; points are sorted by row so a band finds the
+// points that reach it by binary search, and each band writes only its own
+// rows.
+
+enum DensityKernel {QUARTIC, EPANECHNIKOV, GAUSSIAN};
+
+// Gaussian kernels are cut off at this many bandwidths
+static const double gaussian_cutoff = 3.0;
+
+// A point in matrix units, cell centres on whole numbers
+struct DensityPoint {
+  double col, row, weight;
+};
+
+struct less_by_row {
+  inline bool operator() (const DensityPoint& p1, const DensityPoint& p2) {
+    return p1.row < p2.row;
+  }
+};
+
+// Add the kernels of points [first, last) to rows [begin, end) of the grid
+void density_band(const std::vector<DensityPoint> &points, size_t first, size_t last,
+                  RasterInfo &ras, DensityKernel kernel, double radius, double norm,
+                  long begin, long end, double *grid) {
+  double reach_x = radius / ras.xres, reach_y = radius / ras.yres;
+  std::vector<double> dx2, gx;
+  for (size_t i = first; i < last; i++) {
+    const DensityPoint &p = points[i];
+    long c0 = std::max(0L, (long)std::ceil(p.col - reach_x));
+    long c1 = std::min((long)ras.ncol - 1, (long)std::floor(p.col + reach_x));
+    long r0 = std::max(begin, (long)std::ceil(p.row - reach_y));
+    long r1 = std::min(end - 1, (long)std::floor(p.row + reach_y));
+    if (c0 > c1 || r0 > r1) continue;
+    //squared distance of each column over radius squared, shared by all rows
+    dx2.resize(c1 - c0 + 1);
+    for (long c = c0; c <= c1; c++) {
+      double d = (c - p.col) / reach_x;
+      dx2[c - c0] = d * d;
+    }
+    if (kernel == GAUSSIAN) {
+      gx.resize(dx2.size());
+      for (size_t k = 0; k < dx2.size(); k++) {
+        gx[k] = std::exp(-0.5 * gaussian_cutoff * gaussian_cutoff * dx2[k]);
+      }
+    }
+    double k0 = norm * p.weight;
+    for (long r = r0; r <= r1; r++) {
+      double dy = (r - p.row) / reach_y;
+      double lim = 1.0 - dy * dy;
+      if (lim < 0) continue;
+      //the disc's run on this row
+      double half = std::sqrt(lim) * reach_x;
+      long a = std::max(c0, (long)std::ceil(p.col - half));
+      long b = std::min(c1, (long)std::floor(p.col + half));
+      double *line = grid + (size_t)r * ras.ncol;
+      const double *d2 = &dx2[0] - c0;
+      switch (kernel) {
+      case QUARTIC:
+        for (long c = a; c <= b; c++) {
+          double t = std::max(lim - d2[c], 0.0);
+          line[c] += k0 * t * t;
+        }
+        break;
+      case EPANECHNIKOV:
+        for (long c = a; c <= b; c++) {
+          line[c] += k0 * std::max(lim - d2[c], 0.0);
+        }
+        break;
+      case GAUSSIAN: {
+        double ky = k0 * std::exp(-0.5 * gaussian_cutoff * gaussian_cutoff * dy * dy);
+        const double *g = &gx[0] - c0;
+        for (long c = a; c <= b; c++) {
+          line[c] += (d2[c] <= lim) ? ky * g[c] : 0.0;
+        }
+        break;
+      }
+      }
+    }
+  }
+}
+
+// Kernel density of points on a grid
+//
+// @param x,y numeric point coordinates
+// @param extent numeric vector c(xmin, xmax, ymin , ymax)
+// @param dimension integer vector c(ncol, nrow)
+// @param bandwidth kernel radius in map units, for "gaussian" its standard
+// deviation with the kernel cut off at three times that
+// @param kernel one of "quartic", "epanechnikov" or "gaussian"
+// @param weights optional numeric weight of each point, default one
+// @return numeric matrix with dim c(ncol, nrow), density per unit area at
+// each cell centre row by row from the top left as materialized; each kernel
+// integrates to its point's weight
+// [[Rcpp::export]]
+Rcpp::NumericVector point_density(Rcpp::NumericVector &x,
+                                  Rcpp::NumericVector &y,
+                                  Rcpp::NumericVector &extent,
+                                  Rcpp::IntegerVector &dimension,
+                                  double bandwidth,
+                                  std::string kernel = "quartic",
+                                  SEXP weights = R_NilValue) {
+  RasterInfo ras(extent, dimension);
+  if (x.size() != y.size()) Rcpp::stop("x and y must be the same length");
+  if (!(bandwidth > 0)) Rcpp::stop("bandwidth must be positive");
+  Rcpp::NumericVector w;
+  if (!Rf_isNull(weights)) {
+    w = Rcpp::as<Rcpp::NumericVector>(weights);
+    if (w.size() != x.size()) Rcpp::stop("weights must be the same length as x");
+  }
+
+  DensityKernel type;
+  double radius = bandwidth, norm;
+  if (kernel == "quartic") {
+    type = QUARTIC;
+    norm = 3.0 / (M_PI * radius * radius);
+  } else if (kernel == "epanechnikov") {
+    type = EPANECHNIKOV;
+    norm = 2.0 / (M_PI * radius * radius);
+  } else if (kernel == "gaussian") {
+    type = GAUSSIAN;
+    radius = gaussian_cutoff * bandwidth;
+    //renormalized for the mass cut off
+    norm = 1.0 / (2.0 * M_PI * bandwidth * bandwidth *
+      (1.0 - std::exp(-0.5 * gaussian_cutoff * gaussian_cutoff)));
+  } else {
+    Rcpp::stop("kernel must be one of \"quartic\", \"epanechnikov\" or \"gaussian\"");
+  }
+
+  std::vector<DensityPoint> points;
+  points.reserve(x.size());
+  for (R_xlen_t i = 0; i < x.size(); i++) {
+    DensityPoint p;
+    p.col = (x[i] - ras.xmin) / ras.xres - 0.5;
+    p.row = (ras.ymax - y[i]) / ras.yres - 0.5;
+    p.weight = Rf_isNull(weights) ? 1.0 : w[i];
+    if (ISNAN(p.col) || ISNAN(p.row) || ISNAN(p.weight)) continue;
+    points.push_back(p);
+  }
+  std::sort(points.begin(), points.end(), less_by_row());
+
+  Rcpp::NumericVector out((size_t)ras.ncol * ras.nrow);
+  double *grid = out.begin();
+  double reach_y = radius / ras.yres;
+  double cells = M_PI * (radius / ras.xres + 1) * (reach_y + 1);
+  double cost = (double)ras.ncol * ras.nrow + points.size() * cells;
+  //each chunk of rows is a band
+  task_pool().parallel_for(ras.nrow, cost, [&](size_t begin, size_t end) {
+    DensityPoint lo, hi;
+    lo.row = begin - reach_y;
+    hi.row = end - 1 + reach_y;
+    size_t first = std::lower_bound(points.begin(), points.end(), lo, less_by_row()) - points.begin();
+    size_t last = std::upper_bound(points.begin(), points.end(), hi, less_by_row()) - points.begin();
+    density_band(points, first, last, ras, type, radius, norm, begin, end, grid);
+  });
+  out.attr("dim") = Rcpp::Dimension(ras.ncol, ras.nrow);
+  return out;
+}
@@ -0,0 +1,115 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "span.h"
+#include "CollectorList.h"
+#include "simd.h"
+
+// Dasymetric disaggregation
+//
+// Each feature's total is shared over its cells in proportion to a weight:
+// one pass over the spans sums the weights of every feature, a second
+// scales each cell by total / sum. Without weights every cell weighs one.
+// A feature whose weights sum to zero is shared evenly over its cells, so
+// totals are always kept.
+
+// Weight of a cell, missing or negative weights count as zero
+inline double cell_weight(const double *weights, R_xlen_t cell) {
+  if (weights == NULL) return 1.0;
+  double w = weights[cell];
+  return (ISNAN(w) || w < 0) ? 0.0 : w;
+}
+
+// Disaggregate feature totals onto grid cells
+//
+// @param index list of records (xstart, xend, row, poly_id) from burn_polygon()
+// @param dimension integer vector c(ncol, nrow)
+// @param totals numeric total of each feature, by poly_id
+// @param weights optional numeric vector of ncol * nrow ancillary weights,
+// row by row from the top left as materialized
+// @param dense if TRUE return the grid, otherwise value runs
+// @return with dense, numeric matrix with dim c(ncol, nrow) of allocations
+// summed over features; otherwise list of numeric records (xstart, xend, row,
+// poly_id, value), runs of equal allocation within each span
+// [[Rcpp::export]]
+SEXP disaggregate(Rcpp::List &index,
+                  Rcpp::IntegerVector &dimension,
+                  Rcpp::NumericVector &totals,
+                  SEXP weights = R_NilValue,
+                  bool dense = true) {
+  R_xlen_t ncol = dimension[0], nrow = dimension[1];
+  const double *w = NULL;
+  Rcpp::NumericVector weight_values;
+  if (!Rf_isNull(weights)) {
+    weight_values = Rcpp::as<Rcpp::NumericVector>(weights);
+    if (weight_values.size() != ncol * nrow) Rcpp::stop("weights must have ncol * nrow elements");
+    w = weight_values.begin();
+  }
+  std::vector<const int *> records;
+  index_records(index, 4, records);
+
+  //first pass, the weight and cell count of each feature
+  std::vector<double> sum(totals.size(), 0.0), count(totals.size(), 0.0);
+  for (size_t i = 0; i < records.size(); i++) {
+    const int *rec = records[i];
+    if (rec[0] < 0 || rec[1] >= ncol || rec[2] < 0 || rec[2] >= nrow) {
+      Rcpp::stop("index record outside dimension");
+    }
+    if (rec[3] < 0 || (R_xlen_t)rec[3] >= totals.size()) Rcpp::stop("no total for poly_id %i", rec[3]);
+    R_xlen_t row = (R_xlen_t)rec[2] * ncol;
+    for (int x = rec[0]; x <= rec[1]; x++) {
+      sum[rec[3]] += cell_weight(w, row + x);
+    }
+    if (rec[1] >= rec[0]) count[rec[3]] += rec[1] - rec[0] + 1;
+  }
+  //value of one unit of weight, or of one cell when there is no weight
+  std::vector<double> scale(totals.size(), 0.0);
+  std::vector<bool> even(totals.size(), false);
+  for (R_xlen_t i = 0; i < totals.size(); i++) {
+    if (sum[i] > 0) {
+      scale[i] = totals[i] / sum[i];
+    } else if (count[i] > 0) {
+      scale[i] = totals[i] / count[i];
+      even[i] = true;
+    }
+  }
+
+  //second pass, scale each cell
+  if (dense) {
+    Rcpp::NumericVector out(ncol * nrow);
+    double *grid = out.begin();
+    for (size_t i = 0; i < records.size(); i++) {
+      const int *rec = records[i];
+      R_xlen_t row = (R_xlen_t)rec[2] * ncol;
+      double s = scale[rec[3]];
+      const double *fw = even[rec[3]] ? NULL : w;
+      for (int x = rec[0]; x <= rec[1]; x++) {
+        grid[row + x] += s * cell_weight(fw, row + x);
+      }
+    }
+    out.attr("dim") = Rcpp::Dimension(ncol, nrow);
+    return out;
+  }
+
+  //run length encode the allocations of each span
+  const SimdKernels &simd = simd_kernels();
+  std::vector<double> cells;
+  CollectorList out_vector(records.size() + 1);
+  for (size_t i = 0; i < records.size(); i++) {
+    const int *rec = records[i];
+    if (rec[0] > rec[1]) continue;
+    R_xlen_t row = (R_xlen_t)rec[2] * ncol;
+    double s = scale[rec[3]];
+    const double *fw = even[rec[3]] ? NULL : w;
+    cells.resize(rec[1] - rec[0] + 1);
+    for (int x = rec[0]; x <= rec[1]; x++) {
+      cells[x - rec[0]] = s * cell_weight(fw, row + x);
+    }
+    for (size_t k = 0; k < cells.size(); ) {
+      size_t run = simd.equal_run(&cells[k], cells.size() - k);
+      out_vector.push_back(Rcpp::NumericVector::create(rec[0] + k, rec[0] + k + run - 1,
+                                                       rec[2], rec[3], cells[k]));
+      k += run;
+    }
+  }
+  return out_vector.vector();
+}
@@ -0,0 +1,91 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "edge.h"
+#include "check_inputs.h"
+
+#include "rasterize.h"
+
+// Group-wise dissolve
+//
+// Features are swept on the task pool as for burn_polygon(), then the spans
+// of each group are sorted by row and column and merged wherever they
+// overlap or touch, so a group's cells come out once each as the fewest
+// runs, however many of its features cover them. Groups are merged in
+// parallel, each on its own spans.
+
+// Union of spans in place, sorting them first; empty spans are dropped
+void dissolve_spans(std::vector<Span> &spans) {
+  std::sort(spans.begin(), spans.end(), less_by_row_xstart());
+  size_t n = 0;
+  for (size_t i = 0; i < spans.size(); i++) {
+    const Span &sp = spans[i];
+    if (sp.xstart > sp.xend) continue;
+    if (n > 0 && spans[n - 1].row == sp.row && sp.xstart <= spans[n - 1].xend + 1) {
+      spans[n - 1].xend = std::max(spans[n - 1].xend, sp.xend);
+    } else {
+      spans[n++] = sp;
+    }
+  }
+  spans.resize(n);
+}
+
+// Rasterize polygons merged by group
+//
+// @param sf an [sf::sf()] object with a geometry column of POLYGON and/or
+// MULTIPOLYGON objects.
+// @param extent numeric vector c(xmin, xmax, ymin , ymax)
+// @param dimension integer vector c(ncol, nrow)
+// @param group integer group of each feature from 1, such as the codes of a
+// factor; features with NA group are left out
+// @return list of records (xstart, xend, row, poly_id) as from burn_polygon()
+// where poly_id is the zero-based group (group - 1), in group order and by
+// row within a group, with no cell in more than one record of a group
+// [[Rcpp::export]]
+Rcpp::List burn_polygon_dissolve(Rcpp::DataFrame &sf,
+                                 Rcpp::NumericVector &extent,
+                                 Rcpp::IntegerVector &dimension,
+                                 Rcpp::IntegerVector &group) {
+  Rcpp::List polygons;
+  check_inputs_polygon(sf, polygons);  // Also fills in polygons
+  if (group.size() != polygons.size()) Rcpp::stop("group must have one value per feature");
+  //copied out of R for the pool
+  std::vector<int> key(group.begin(), group.end());
+  int ngroup = 0;
+  for (size_t i = 0; i < key.size(); i++) {
+    if (key[i] == NA_INTEGER) continue;
+    if (key[i] < 1) Rcpp::stop("group must be positive");
+    ngroup = std::max(ngroup, key[i]);
+  }
+
+  RasterInfo ras(extent, dimension);
+  std::vector<Feature> features;
+  features_from_list(polygons, features);
+  std::vector< std::vector<Span> > parts(features.size());
+  double cost = 0;
+  for (size_t i = 0; i < features.size(); i++) cost += feature_cost(features[i], ras);
+  task_pool().parallel_for(features.size(), cost, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      if (key[i] == NA_INTEGER) continue;
+      rasterize_feature(features[i], ras, parts[i], key[i] - 1);
+    }
+  });
+
+  std::vector< std::vector<Span> > groups(ngroup);
+  double merge_cost = 0;
+  for (size_t i = 0; i < parts.size(); i++) {
+    if (parts[i].empty()) continue;
+    std::vector<Span> &g = groups[key[i] - 1];
+    g.insert(g.end(), parts[i].begin(), parts[i].end());
+    merge_cost += parts[i].size();
+    std::vector<Span>().swap(parts[i]);
+  }
+  task_pool().parallel_for(groups.size(), merge_cost, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) dissolve_spans(groups[i]);
+  });
+
+  std::vector<Span> spans;
+  for (size_t i = 0; i < groups.size(); i++) {
+    spans.insert(spans.end(), groups[i].begin(), groups[i].end());
+  }
+  return spans_to_list(spans);
+}
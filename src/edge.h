@@ -32,6 +32,7 @@ struct Edge_polygon {
   unsigned int yend;  //the matrix row below the end of the line
   long double dxdy; //change in x per y. Long helps with some rounding errors
   long double x; //the x location on the first matrix row intersected
+  int winding; //+1 for an edge running down the matrix, -1 running up
 
   Edge_polygon(double x0, double y0, double x1, double y1, RasterInfo &ras,
        double y0c, double y1c) {
@@ -46,11 +47,13 @@ struct Edge_polygon {
       dxdy = (x1-x0)/(y1-y0);
       x = x0 + (ystart - y0)*dxdy;
       yend = y1c;
+      winding = 1;
     } else {
       ystart = std::max(y1c, 0.0);
       dxdy = (x0-x1)/(y0-y1);
       x = x1 + (ystart - y1)*dxdy;
       yend = y0c;
+      winding = -1;
     }
   }
 };
@@ -44,6 +44,26 @@ void edgelist_polygon(Rcpp::RObject polygon, RasterInfo &ras, std::list<Edge_pol
 }
 
 
+//  Builds an edge list from the native rings of a feature
+void edgelist_feature(const Feature &feature, RasterInfo &ras, std::list<Edge_polygon> &edges) {
+  double y0, y1, y0c, y1c;
+  for(Feature::const_iterator ring = feature.begin(); ring != feature.end(); ++ring) {
+    const std::vector<double> &x = (*ring).x, &y = (*ring).y;
+    //Add edge to list if it's not horizontal and is in the raster
+    for(size_t i = 0; i + 1 < y.size(); ++i) {
+      y0 = (ras.ymax - y[i])/ras.yres - 0.5;
+      y1 = (ras.ymax - y[i + 1])/ras.yres - 0.5;
+      if(y0 > 0 || y1 > 0) {  //only both with edges that are in the raster
+        y0c = std::ceil(y0);
+        y1c = std::ceil(y1);
+        if(y0c != y1c) {  //only bother with non-horizontal edges
+          edges.push_back(Edge_polygon(x[i], y0, x[i + 1], y1, ras, y0c, y1c));
+        }
+      }
+    }
+  }
+}
+
 
 void edgelist_line(Rcpp::RObject line, RasterInfo &ras, std::list<Edge_line> &edges) {
 
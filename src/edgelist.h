@@ -2,10 +2,12 @@
 #define EDGELIST
 
 #include "edge.h"
+#include "geometry.h"
 #include "stdlib.h"
 #include "Rcpp.h"
 using namespace Rcpp;
 extern void edgelist_polygon(Rcpp::RObject polygon, RasterInfo &ras, std::list<Edge_polygon> &edges);
+extern void edgelist_feature(const Feature &feature, RasterInfo &ras, std::list<Edge_polygon> &edges);
 extern void edgelist_line(Rcpp::RObject polygon, RasterInfo &ras, std::list<Edge_line> &edges);
 
 #endif
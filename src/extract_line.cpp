@@ -0,0 +1,107 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "edge.h"
+#include "check_inputs.h"
+
+#include "geometry.h"
+#include "rasterize.h"
+#include "mapped.h"
+#include "traverse.h"
+#include "trace.h"
+
+// Length-weighted statistics of one line over the cells it passes through
+struct LineStats {
+  double length, sum, min, max;
+  LineStats() : length(0), sum(0), min(R_PosInf), max(R_NegInf) {}
+};
+
+void extract_feature(const Feature &feature, RasterInfo &ras, const double *values, LineStats &stats) {
+  for(Feature::const_iterator ring = feature.begin(); ring != feature.end(); ++ring) {
+    const std::vector<double> &x = (*ring).x, &y = (*ring).y;
+    for(size_t i = 0; i + 1 < x.size(); ++i) {
+      traverse_segment(x[i], y[i], x[i + 1], y[i + 1], ras,
+                       [&](unsigned int col, unsigned int row, double length) {
+        double v = values[(size_t)row * ras.ncol + col];
+        if (ISNAN(v)) return;
+        stats.length += length;
+        stats.sum += v * length;
+        stats.min = std::min(stats.min, v);
+        stats.max = std::max(stats.max, v);
+      });
+    }
+  }
+}
+
+// Length-weighted raster values along lines
+//
+// Each line is traversed cell by cell with the length inside every cell, and
+// the cell values are read and accumulated on the way, so the traversal is
+// never materialized. Values are a numeric vector in memory or a file of raw
+// doubles that is memory mapped, so a grid larger than memory can be read.
+//
+// @param sf an [sf::sf()] object with a geometry column of LINESTRING and/or
+// MULTILINESTRING objects.
+// @param extent numeric vector c(xmin, xmax, ymin , ymax)
+// @param dimension integer vector c(ncol, nrow)
+// @param values numeric vector of ncol * nrow cell values row by row from the
+// top left as materialized, or the path of a file holding them as native
+// 8 byte doubles
+// @param offset bytes to skip at the start of the file, a multiple of 8
+// @return numeric matrix with a row per line and columns length (within
+// valued cells, map units), sum (of value times length), mean, min and max;
+// NA values are skipped
+// [[Rcpp::export]]
+Rcpp::NumericMatrix extract_line(Rcpp::DataFrame &sf,
+                                 Rcpp::NumericVector &extent,
+                                 Rcpp::IntegerVector &dimension,
+                                 SEXP values,
+                                 double offset = 0) {
+  Rcpp::List lines;
+  check_inputs_line(sf, lines);  // Also fills in lines
+
+  RasterInfo ras(extent, dimension);
+  size_t ncell = (size_t)ras.ncol * ras.nrow;
+  const double *v = NULL;
+  Rcpp::NumericVector in_memory;
+  MappedFile mapped;
+  if (TYPEOF(values) == STRSXP) {
+    std::string path = Rcpp::as<std::string>(values);
+    if (!mapped.open(path)) Rcpp::stop("cannot map file %s", path);
+    if (!R_FINITE(offset) || offset < 0 || offset != std::floor(offset)) {
+      Rcpp::stop("offset must be a whole number of bytes, not negative");
+    }
+    if (offset > mapped.size()) Rcpp::stop("file is too small for ncol * nrow values");
+    size_t skip = offset;
+    if (skip % sizeof(double) != 0) Rcpp::stop("offset must be a multiple of 8 bytes");
+    if (mapped.size() - skip < ncell * sizeof(double)) Rcpp::stop("file is too small for ncol * nrow values");
+    v = (const double *)(mapped.data() + skip);
+  } else {
+    in_memory = Rcpp::as<Rcpp::NumericVector>(values);
+    if ((size_t)in_memory.size() != ncell) Rcpp::stop("values must have ncol * nrow elements");
+    v = in_memory.begin();
+  }
+
+  std::vector<Feature> features;
+  features_from_list(lines, features);
+  std::vector<LineStats> stats(features.size());
+  double cost = 0;
+  for (size_t i = 0; i < features.size(); i++) cost += feature_cost(features[i], ras);
+  task_pool().parallel_for(features.size(), cost, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      TRACE_SCOPE("extract line", i);
+      extract_feature(features[i], ras, v, stats[i]);
+    }
+  });
+
+  Rcpp::NumericMatrix out(features.size(), 5);
+  for (size_t i = 0; i < stats.size(); i++) {
+    bool any = stats[i].length > 0;
+    out(i, 0) = stats[i].length;
+    out(i, 1) = stats[i].sum;
+    out(i, 2) = any ? stats[i].sum / stats[i].length : NA_REAL;
+    out(i, 3) = any ? stats[i].min : NA_REAL;
+    out(i, 4) = any ? stats[i].max : NA_REAL;
+  }
+  Rcpp::colnames(out) = Rcpp::CharacterVector::create("length", "sum", "mean", "min", "max");
+  return out;
+}
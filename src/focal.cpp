@@ -0,0 +1,115 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "span.h"
+#include "pool.h"
+
+// Focal coverage
+//
+// The number of covered cells in a moving window, computed from the index
+// without a dense grid of the coverage. Records are bucketed by row; each
+// row's coverage is built from its records by a difference array, so
+// overlapping records count once, and a prefix sum over it gives every
+// window's count along the row in constant time. Rows are then combined by
+// a running column sum over the window's rows, kept in a ring buffer of
+// window height. Row bands run on the task pool, each keeping only its own
+// window of rows.
+
+// Covered cells in the window of each column on one row
+void focal_row(const std::vector<const int *> &records, const std::vector<size_t> &offset,
+               long row, long ncol, long half, int poly_id,
+               std::vector<int> &diff, std::vector<int> &prefix, int *count) {
+  std::fill(diff.begin(), diff.end(), 0);
+  for (size_t i = offset[row]; i < offset[row + 1]; i++) {
+    const int *rec = records[i];
+    if (rec[0] > rec[1] || (poly_id >= 0 && rec[3] != poly_id)) continue;
+    diff[rec[0]]++;
+    diff[rec[1] + 1]--;
+  }
+  int depth = 0;
+  prefix[0] = 0;
+  for (long x = 0; x < ncol; x++) {
+    depth += diff[x];
+    prefix[x + 1] = prefix[x] + (depth > 0);
+  }
+  for (long x = 0; x < ncol; x++) {
+    count[x] = prefix[std::min(x + half + 1, ncol)] - prefix[std::max(x - half, 0L)];
+  }
+}
+
+// Coverage of the index in a moving window
+//
+// @param index list of records (xstart, xend, row, poly_id) from burn_polygon()
+// @param dimension integer vector c(ncol, nrow)
+// @param size integer window size c(width, height) in cells, odd, or one
+// value for a square
+// @param poly_id count only this feature (or group, for an index from
+// burn_polygon_dissolve()), or -1 for cells covered by any
+// @param fraction if TRUE the fraction of the window's cells within the grid
+// that are covered, otherwise the count of covered cells
+// @return numeric matrix with dim c(ncol, nrow), row by row from the top
+// left as materialized
+// [[Rcpp::export]]
+Rcpp::NumericVector focal_coverage(Rcpp::List &index,
+                                   Rcpp::IntegerVector &dimension,
+                                   Rcpp::IntegerVector &size,
+                                   int poly_id = -1,
+                                   bool fraction = true) {
+  long ncol = dimension[0], nrow = dimension[1];
+  if (size.size() < 1 || size.size() > 2) Rcpp::stop("size must be one or two values");
+  long wx = size[0], wy = size[size.size() - 1];
+  if (wx < 1 || wy < 1 || wx % 2 == 0 || wy % 2 == 0) Rcpp::stop("size must be odd and positive");
+  long hx = wx / 2, hy = wy / 2;
+
+  //records by row, in a counting sort
+  std::vector<const int *> records;
+  index_records(index, 4, records);
+  std::vector<size_t> offset(nrow + 1, 0);
+  for (size_t i = 0; i < records.size(); i++) {
+    const int *rec = records[i];
+    if (rec[0] < 0 || rec[1] >= ncol || rec[2] < 0 || rec[2] >= nrow) {
+      Rcpp::stop("index record outside dimension");
+    }
+    offset[rec[2] + 1]++;
+  }
+  for (long r = 0; r < nrow; r++) offset[r + 1] += offset[r];
+  std::vector<const int *> by_row(records.size());
+  std::vector<size_t> next(offset.begin(), offset.end() - 1);
+  for (size_t i = 0; i < records.size(); i++) by_row[next[records[i][2]]++] = records[i];
+
+  Rcpp::NumericVector out(ncol * nrow);
+  double *grid = out.begin();
+  double cost = (double)records.size() + (double)ncol * nrow * 3;
+  //each chunk of rows is a band, with the window's rows above and below
+  task_pool().parallel_for(nrow, cost, [&](size_t begin, size_t end) {
+    long b = begin, e = end;
+    std::vector<int> diff(ncol + 1), prefix(ncol + 1), ring(wy * ncol), sum(ncol, 0);
+    long first = std::max(b - hy, 0L);
+    for (long r = first; r < e + hy; r++) {
+      //the row leaving the window
+      long old = r - wy;
+      if (old >= first && old < nrow) {
+        const int *count = &ring[(old % wy) * ncol];
+        for (long x = 0; x < ncol; x++) sum[x] -= count[x];
+      }
+      if (r < nrow) {
+        int *count = &ring[(r % wy) * ncol];
+        focal_row(by_row, offset, r, ncol, hx, poly_id, diff, prefix, count);
+        for (long x = 0; x < ncol; x++) sum[x] += count[x];
+      }
+      long o = r - hy;
+      if (o < b) continue;
+      double *line = grid + o * ncol;
+      if (!fraction) {
+        for (long x = 0; x < ncol; x++) line[x] = sum[x];
+        continue;
+      }
+      double rows = std::min(o + hy, nrow - 1) - std::max(o - hy, 0L) + 1;
+      for (long x = 0; x < ncol; x++) {
+        double cols = std::min(x + hx, ncol - 1) - std::max(x - hx, 0L) + 1;
+        line[x] = sum[x] / (rows * cols);
+      }
+    }
+  });
+  out.attr("dim") = Rcpp::Dimension(ncol, nrow);
+  return out;
+}
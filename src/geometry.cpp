@@ -0,0 +1,39 @@
+#include "geometry.h"
+
+//  Copies the nodes of a geometry into native rings, in the order
+//  edgelist_polygon() would visit them
+void feature_from_sexp(Rcpp::RObject geometry, Feature &feature) {
+  //iterate recursively over the list
+  switch(geometry.sexp_type()) {
+  case REALSXP: {
+    //if the object is numeric, it an Nx2 matrix of nodes.
+    Rcpp::NumericMatrix mat(geometry);
+    Ring ring;
+    ring.x.assign(mat.begin(), mat.begin() + mat.nrow());
+    ring.y.assign(mat.begin() + mat.nrow(), mat.begin() + 2 * mat.nrow());
+    feature.push_back(ring);
+    break;
+  };
+  case VECSXP: {
+    //if the object is a list, recurse over that
+    Rcpp::List geomlist = Rcpp::as<Rcpp::List>(geometry);
+    for(Rcpp::List::iterator it = geomlist.begin();
+        it != geomlist.end();
+        ++it) {
+      feature_from_sexp(Rcpp::wrap(*it), feature);
+    }
+    break;
+  }
+  default: {
+    Rcpp::stop("incompatible SEXP; only accepts lists and REALSXPs");
+  }
+  }
+}
+
+void features_from_list(Rcpp::List &geometries, std::vector<Feature> &features) {
+  features.resize(geometries.size());
+  Rcpp::List::iterator g = geometries.begin();
+  for(; g != geometries.end(); ++g) {
+    feature_from_sexp( (*g), features[g.index()]);
+  }
+}
@@ -0,0 +1,18 @@
+#ifndef GEOMETRY
+#define GEOMETRY
+
+#include "Rcpp.h"
+using namespace Rcpp;
+
+// Native copy of the coordinates of one feature, every matrix of a POLYGON,
+// MULTIPOLYGON, LINESTRING or MULTILINESTRING becomes a ring. Unlike the sf
+// list this holds no R objects, so it can be used away from the R thread.
+struct Ring {
+  std::vector<double> x, y;
+};
+typedef std::vector<Ring> Feature;
+
+extern void feature_from_sexp(Rcpp::RObject geometry, Feature &feature);
+extern void features_from_list(Rcpp::List &geometries, std::vector<Feature> &features);
+
+#endif
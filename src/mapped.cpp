@@ -0,0 +1,83 @@
+#include "mapped.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() : data_(NULL), size_(0), file_(NULL), mapping_(NULL), fd_(-1) {}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string &path) {
+  close();
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE) return false;
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+    CloseHandle(file);
+    return false;
+  }
+  HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (mapping == NULL) {
+    CloseHandle(file);
+    return false;
+  }
+  void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (view == NULL) {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return false;
+  }
+  file_ = file;
+  mapping_ = mapping;
+  data_ = (const unsigned char *)view;
+  size_ = (size_t)size.QuadPart;
+  return true;
+}
+
+void MappedFile::close() {
+  if (data_ != NULL) UnmapViewOfFile(data_);
+  if (mapping_ != NULL) CloseHandle((HANDLE)mapping_);
+  if (file_ != NULL) CloseHandle((HANDLE)file_);
+  data_ = NULL;
+  size_ = 0;
+  file_ = mapping_ = NULL;
+}
+
+#else
+
+bool MappedFile::open(const std::string &path) {
+  close();
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    ::close(fd);
+    return false;
+  }
+  void *view = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  if (view == MAP_FAILED) {
+    ::close(fd);
+    return false;
+  }
+  fd_ = fd;
+  data_ = (const unsigned char *)view;
+  size_ = st.st_size;
+  return true;
+}
+
+void MappedFile::close() {
+  if (data_ != NULL) munmap((void *)data_, size_);
+  if (fd_ >= 0) ::close(fd_);
+  data_ = NULL;
+  size_ = 0;
+  fd_ = -1;
+}
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef MAPPED
+#define MAPPED
+
+#include <string>
+#include <cstddef>
+
+// A read-only memory map of a whole file
+//
+// Plain C++ with no R headers, as windows.h and R's headers clash.
+class MappedFile {
+public:
+  MappedFile();
+  ~MappedFile() { close(); }
+
+  bool open(const std::string &path);
+  void close();
+  const unsigned char *data() const { return data_; }
+  size_t size() const { return size_; }
+
+private:
+  const unsigned char *data_;
+  size_t size_;
+  void *file_, *mapping_;  // HANDLEs on Windows
+  int fd_;
+};
+
+#endif
@@ -0,0 +1,206 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "edge.h"
+#include "span.h"
+#include "pool.h"
+#include "blockcache.h"
+#include "simd.h"
+#include "trace.h"
+
+#include <cstdio>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <zlib.h>
+
+// Span-driven extraction over a tiled mosaic
+//
+// The grid is cut into blocks of bw x bh cells, each its own file of native
+// 8 byte doubles row by row, raw or zlib compressed; blocks at the right and
+// bottom edges are short. Spans are cut at block edges and the pieces sorted
+// by block, so every block needed is read and decoded once and no other is
+// touched. Blocks are decoded on the task pool through an LRU cache kept for
+// the session, so repeated extractions from the same files read them once,
+// and each piece's summary is reduced by feature at the end.
+
+struct MosaicPiece {
+  size_t block;
+  unsigned int xstart, xend, row, poly_id;  // in grid cells
+};
+
+struct less_by_block {
+  inline bool operator() (const MosaicPiece& p1, const MosaicPiece& p2) {
+    return ((p1.block < p2.block) ||
+            ((p1.block == p2.block) && (p1.row < p2.row)));
+  }
+};
+
+struct CellStats {
+  double count, sum, min, max;
+  CellStats() : count(0), sum(0), min(R_PosInf), max(R_NegInf) {}
+};
+
+// Blocks decoded in this session, by file
+BlockCache &mosaic_cache() {
+  static BlockCache cache;
+  return cache;
+}
+
+// Cache key of a block file: its path, how it is read and the size and time
+// of the file now, so a file written again is read again
+std::string block_key(const std::string &path, bool compressed, size_t ncell) {
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0) throw std::runtime_error("cannot open block " + path);
+  return path + "\n" + (compressed ? "z" : "r") + std::to_string(ncell) + "\n" +
+    std::to_string((long long)st.st_size) + "\n" + std::to_string((long long)st.st_mtime);
+}
+
+// Read a whole block file, inflating it if compressed
+void read_block(const std::string &path, bool compressed, size_t ncell, std::vector<double> &block) {
+  FILE *file = fopen(path.c_str(), "rb");
+  if (file == NULL) throw std::runtime_error("cannot open block " + path);
+  std::vector<unsigned char> bytes;
+  unsigned char buffer[65536];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    bytes.insert(bytes.end(), buffer, buffer + n);
+  }
+  fclose(file);
+  if (bytes.empty()) throw std::runtime_error("block " + path + " is empty");
+
+  block.resize(ncell);
+  uLongf size = ncell * sizeof(double);
+  if (compressed) {
+    if (uncompress((Bytef *)block.data(), &size, bytes.data(), bytes.size()) != Z_OK ||
+        size != ncell * sizeof(double)) {
+      throw std::runtime_error("cannot inflate block " + path);
+    }
+  } else {
+    if (bytes.size() != size) throw std::runtime_error("block " + path + " is the wrong size");
+    std::memcpy(block.data(), bytes.data(), size);
+  }
+}
+
+// Summarize cell values of each feature from a tiled mosaic
+//
+// @param index list of records (xstart, xend, row, poly_id) from burn_polygon()
+// @param dimension integer vector c(ncol, nrow) of the whole mosaic
+// @param files character vector of block files, block rows from the top and
+// blocks left to right within them; NA for a block with no data
+// @param block_dimension integer vector c(bw, bh), cells in a block
+// @param compressed whether block files are zlib compressed (as from
+// memCompress(type = "gzip"))
+// @param cache_mb size of the block cache, which is shared by all calls and
+// kept for the session
+// @return numeric matrix with a row per poly_id (up to the largest in the
+// index) and columns count, sum, mean, min and max of the non-missing values
+// [[Rcpp::export]]
+Rcpp::NumericMatrix extract_mosaic(Rcpp::List &index,
+                                   Rcpp::IntegerVector &dimension,
+                                   Rcpp::CharacterVector &files,
+                                   Rcpp::IntegerVector &block_dimension,
+                                   bool compressed = false,
+                                   double cache_mb = 64) {
+  long ncol = dimension[0], nrow = dimension[1];
+  long bw = block_dimension[0], bh = block_dimension[1];
+  if (bw < 1 || bh < 1) Rcpp::stop("block_dimension must be positive");
+  long nbx = (ncol + bw - 1) / bw, nby = (nrow + bh - 1) / bh;
+  if (files.size() != nbx * nby) Rcpp::stop("need %i block files, one per block", (int)(nbx * nby));
+  //copied out of R, the loader runs on pool threads
+  std::vector<std::string> paths(files.size());
+  std::vector<bool> present(files.size());
+  for (R_xlen_t i = 0; i < files.size(); i++) {
+    present[i] = STRING_ELT(files, i) != NA_STRING;
+    if (present[i]) paths[i] = Rcpp::as<std::string>(files[i]);
+  }
+
+  std::vector<const int *> records;
+  index_records(index, 4, records);
+  std::vector<MosaicPiece> pieces;
+  int nfeature = 0;
+  for (size_t i = 0; i < records.size(); i++) {
+    const int *rec = records[i];
+    if (rec[0] < 0 || rec[1] >= ncol || rec[2] < 0 || rec[2] >= nrow) {
+      Rcpp::stop("index record outside dimension");
+    }
+    if (rec[3] < 0) Rcpp::stop("poly_id must not be negative");
+    nfeature = std::max(nfeature, rec[3] + 1);
+    long by = rec[2] / bh;
+    for (long x = rec[0]; x <= rec[1]; ) {
+      long bx = x / bw;
+      MosaicPiece piece;
+      piece.block = by * nbx + bx;
+      piece.xstart = x;
+      piece.xend = std::min((long)rec[1], (bx + 1) * bw - 1);
+      piece.row = rec[2];
+      piece.poly_id = rec[3];
+      if (present[piece.block]) pieces.push_back(piece);
+      x = piece.xend + 1;
+    }
+  }
+  std::sort(pieces.begin(), pieces.end(), less_by_block());
+
+  //one task per block in use
+  std::vector<size_t> starts;
+  for (size_t i = 0; i < pieces.size(); i++) {
+    if (i == 0 || pieces[i].block != pieces[i - 1].block) starts.push_back(i);
+  }
+  starts.push_back(pieces.size());
+
+  BlockCache &cache = mosaic_cache();
+  cache.set_capacity(std::max(cache_mb, 0.0) * 1024 * 1024);
+  const SimdKernels &simd = simd_kernels();
+  std::vector<CellStats> partial(pieces.size());
+  double cost = (double)pieces.size() + (double)(starts.size() - 1) * bw * bh;
+  task_pool().parallel_for(starts.size() - 1, cost, [&](size_t begin, size_t end) {
+    for (size_t b = begin; b < end; b++) {
+      size_t id = pieces[starts[b]].block;
+      TRACE_SCOPE("block", id);
+      long x0 = (id % nbx) * bw, y0 = (id / nbx) * bh;
+      long w = std::min(bw, ncol - x0), h = std::min(bh, nrow - y0);
+      const std::string &path = paths[id];
+      BlockCache::BlockPtr block = cache.get(block_key(path, compressed, w * h),
+                                             [&](BlockCache::Block &values) {
+        read_block(path, compressed, w * h, values);
+      });
+      for (size_t i = starts[b]; i < starts[b + 1]; i++) {
+        const double *line = block->data() + (pieces[i].row - y0) * w;
+        CellStats &stats = partial[i];
+        simd.span_stats(line + (pieces[i].xstart - x0), pieces[i].xend - pieces[i].xstart + 1,
+                        &stats.count, &stats.sum, &stats.min, &stats.max);
+      }
+    }
+  });
+
+  std::vector<CellStats> stats(nfeature);
+  for (size_t i = 0; i < pieces.size(); i++) {
+    CellStats &s = stats[pieces[i].poly_id];
+    s.count += partial[i].count;
+    s.sum += partial[i].sum;
+    s.min = std::min(s.min, partial[i].min);
+    s.max = std::max(s.max, partial[i].max);
+  }
+  Rcpp::NumericMatrix out(nfeature, 5);
+  for (int i = 0; i < nfeature; i++) {
+    bool any = stats[i].count > 0;
+    out(i, 0) = stats[i].count;
+    out(i, 1) = stats[i].sum;
+    out(i, 2) = any ? stats[i].sum / stats[i].count : NA_REAL;
+    out(i, 3) = any ? stats[i].min : NA_REAL;
+    out(i, 4) = any ? stats[i].max : NA_REAL;
+  }
+  Rcpp::colnames(out) = Rcpp::CharacterVector::create("count", "sum", "mean", "min", "max");
+  return out;
+}
+
+// Blocks held in the mosaic block cache
+//
+// @return list with blocks, the number of decoded blocks held, bytes, their
+// size, and loads, the number of blocks read from files this session
+// [[Rcpp::export]]
+Rcpp::List mosaic_cache_info() {
+  size_t blocks, bytes, loads;
+  mosaic_cache().usage(blocks, bytes, loads);
+  return Rcpp::List::create(Rcpp::Named("blocks") = (double)blocks,
+                            Rcpp::Named("bytes") = (double)bytes,
+                            Rcpp::Named("loads") = (double)loads);
+}
@@ -0,0 +1,124 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "edge.h"
+#include "check_inputs.h"
+
+#include "geometry.h"
+#include "rasterize.h"
+#include "simd.h"
+
+// Output orientation
+//
+// The sweep always runs along rows measured down from ymax. Other orientations
+// are a change of coordinates before the sweep: for vertical runs x and y swap
+// roles (x' = -y, y' = -x, so runs go down a column and columns count from
+// xmin), and south-up rows mirror y (y' = -y). The transformed grid samples
+// the same cell centres, so only the layout of the spans changes; the one
+// exception is the clamping of edges beyond the grid, which follows the run
+// direction.
+
+// Map a grid and its features into the frame the sweep runs in
+void orient_features(std::vector<Feature> &features, Rcpp::NumericVector &extent,
+                     Rcpp::IntegerVector &dimension, bool column_major, bool south_up,
+                     Rcpp::NumericVector &oriented_extent, Rcpp::IntegerVector &oriented_dimension) {
+  double xmin = extent[0], xmax = extent[1], ymin = extent[2], ymax = extent[3];
+  if (column_major) {
+    //position along the run is the row, down or up, the run's line is the column
+    if (south_up) {
+      oriented_extent = Rcpp::NumericVector::create(ymin, ymax, -xmax, -xmin);
+    } else {
+      oriented_extent = Rcpp::NumericVector::create(-ymax, -ymin, -xmax, -xmin);
+    }
+    oriented_dimension = Rcpp::IntegerVector::create(dimension[1], dimension[0]);
+  } else {
+    if (south_up) {
+      oriented_extent = Rcpp::NumericVector::create(xmin, xmax, -ymax, -ymin);
+    } else {
+      oriented_extent = Rcpp::NumericVector::create(xmin, xmax, ymin, ymax);
+    }
+    oriented_dimension = Rcpp::IntegerVector::create(dimension[0], dimension[1]);
+  }
+  if (!column_major && !south_up) return;
+
+  for (size_t i = 0; i < features.size(); i++) {
+    for (size_t k = 0; k < features[i].size(); k++) {
+      std::vector<double> &x = features[i][k].x, &y = features[i][k].y;
+      for (size_t j = 0; j < x.size(); j++) {
+        double xj = x[j], yj = y[j];
+        if (column_major) {
+          x[j] = south_up ? yj : -yj;
+          y[j] = -xj;
+        } else {
+          y[j] = -yj;
+        }
+      }
+    }
+  }
+}
+
+// Rasterize polygons as runs in a chosen orientation
+//
+// @param sf an [sf::sf()] object with a geometry column of POLYGON and/or
+// MULTIPOLYGON objects.
+// @param extent numeric vector c(xmin, xmax, ymin , ymax)
+// @param dimension integer vector c(ncol, nrow)
+// @param column_major if TRUE runs are vertical, down each column
+// @param south_up if TRUE rows count up from ymin instead of down from ymax
+// @return list of records (start, end, line, poly_id): with column_major the
+// runs are rows start to end (inclusive) in column line, otherwise as
+// burn_polygon() with columns start to end in row line
+// [[Rcpp::export]]
+Rcpp::List burn_polygon_oriented(Rcpp::DataFrame &sf,
+                                 Rcpp::NumericVector &extent,
+                                 Rcpp::IntegerVector &dimension,
+                                 bool column_major = false,
+                                 bool south_up = false) {
+  Rcpp::List polygons;
+  check_inputs_polygon(sf, polygons);  // Also fills in polygons
+
+  std::vector<Feature> features;
+  features_from_list(polygons, features);
+  Rcpp::NumericVector oriented_extent;
+  Rcpp::IntegerVector oriented_dimension;
+  orient_features(features, extent, dimension, column_major, south_up,
+                  oriented_extent, oriented_dimension);
+
+  RasterInfo ras(oriented_extent, oriented_dimension);
+  std::vector<Span> spans;
+  rasterize_features(features, ras, spans, task_pool());
+  return spans_to_list(spans);
+}
+
+// Materialize an oriented index as a count matrix
+//
+// Runs are contiguous in the output, so a column major index fills an R
+// matrix of nrow rows directly.
+//
+// @param index list of records (start, end, line, poly_id) from
+// burn_polygon_oriented() or burn_polygon()
+// @param dimension integer vector c(ncol, nrow) of the grid
+// @param column_major whether the index runs down columns
+// @return integer matrix with dim c(nrow, ncol) when column_major, otherwise
+// c(ncol, nrow) (one row per grid column), of the number of features per cell
+// [[Rcpp::export]]
+Rcpp::IntegerVector materialize_oriented(Rcpp::List &index,
+                                         Rcpp::IntegerVector &dimension,
+                                         bool column_major = false) {
+  R_xlen_t len = column_major ? dimension[1] : dimension[0];
+  R_xlen_t nline = column_major ? dimension[0] : dimension[1];
+  Rcpp::IntegerVector out(len * nline);
+  std::vector<const int *> records;
+  index_records(index, 4, records);
+
+  const SimdKernels &simd = simd_kernels();
+  int *cell = out.begin();
+  for (size_t i = 0; i < records.size(); i++) {
+    const int *rec = records[i];
+    if (rec[0] < 0 || rec[1] >= len || rec[2] < 0 || rec[2] >= nline) {
+      Rcpp::stop("index record outside dimension");
+    }
+    if (rec[1] >= rec[0]) simd.span_fill(cell + rec[2] * len + rec[0], rec[1] - rec[0] + 1);
+  }
+  out.attr("dim") = Rcpp::Dimension(len, nline);
+  return out;
+}
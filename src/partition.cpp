@@ -0,0 +1,239 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "edge.h"
+#include "check_inputs.h"
+
+#include "bands.h"
+#include "edgelist.h"
+#include "spanfile.h"
+
+// Cost-balanced partitions
+//
+// The work of a row band is close to the number of edge crossings on its
+// rows, which the edge table gives without sweeping: each edge crosses every
+// row from ystart up to yend. Equal-height bands are badly unbalanced on
+// coastlines and other layers whose detail sits in a few rows, so bands are
+// cut where the running total of crossings reaches each k / K of the whole.
+// Each part can then be burned on its own, in a process or on another node,
+// and the partial results merged back into the order of burn_polygon().
+
+// Estimated cost of each row, edge crossings plus a little for the row itself
+void row_costs(const std::vector<Feature> &features, RasterInfo &ras, std::vector<double> &cost) {
+  std::vector<double> diff(ras.nrow + 1, 0.0);
+  std::mutex diff_mutex;
+  double work = 0;
+  for (size_t i = 0; i < features.size(); i++) work += feature_cost(features[i], ras);
+  task_pool().parallel_for(features.size(), work, [&](size_t begin, size_t end) {
+    std::vector<double> local(ras.nrow + 1, 0.0);
+    for (size_t i = begin; i < end; i++) {
+      std::list<Edge_polygon> edges;
+      edgelist_feature(features[i], ras, edges);
+      for (std::list<Edge_polygon>::iterator it = edges.begin(); it != edges.end(); ++it) {
+        unsigned int y0 = std::min((*it).ystart, ras.nrow), y1 = std::min((*it).yend, ras.nrow);
+        if (y0 >= y1) continue;
+        local[y0] += 1;
+        local[y1] -= 1;
+      }
+    }
+    std::lock_guard<std::mutex> lock(diff_mutex);
+    for (size_t r = 0; r <= ras.nrow; r++) diff[r] += local[r];
+  });
+  cost.resize(ras.nrow);
+  double crossings = 0;
+  for (size_t r = 0; r < ras.nrow; r++) {
+    crossings += diff[r];
+    cost[r] = crossings + 1;
+  }
+}
+
+// Cut rows into parts of near-equal total cost, every part at least one row
+void balanced_row_bands(const std::vector<double> &cost, size_t parts, std::vector<unsigned int> &breaks) {
+  size_t nrow = cost.size();
+  parts = std::max(std::min(parts, nrow), (size_t)1);
+  std::vector<double> cumulative(nrow + 1, 0.0);
+  for (size_t r = 0; r < nrow; r++) cumulative[r + 1] = cumulative[r] + cost[r];
+  breaks.assign(1, 0);
+  size_t r = 0;
+  for (size_t k = 1; k < parts; k++) {
+    double target = cumulative[nrow] * k / parts;
+    r = std::max(r, (size_t)breaks.back() + 1);
+    while (r < nrow - (parts - k) && cumulative[r] < target) r++;
+    breaks.push_back(r);
+  }
+  breaks.push_back(nrow);
+}
+
+// Plan row bands of near-equal burn cost
+//
+// @param sf an [sf::sf()] object with a geometry column of POLYGON and/or
+// MULTIPOLYGON objects.
+// @param extent numeric vector c(xmin, xmax, ymin , ymax)
+// @param dimension integer vector c(ncol, nrow)
+// @param parts number of bands
+// @return list with breaks, integer row breaks from 0 to nrow where part k is
+// rows [breaks[k], breaks[k + 1]), and cost, the estimated cost of each part
+// [[Rcpp::export]]
+Rcpp::List plan_row_bands(Rcpp::DataFrame &sf,
+                          Rcpp::NumericVector &extent,
+                          Rcpp::IntegerVector &dimension,
+                          int parts) {
+  Rcpp::List polygons;
+  check_inputs_polygon(sf, polygons);  // Also fills in polygons
+  if (parts < 1) Rcpp::stop("parts must be at least 1");
+  RasterInfo ras(extent, dimension);
+  std::vector<Feature> features;
+  features_from_list(polygons, features);
+  std::vector<double> cost;
+  row_costs(features, ras, cost);
+  std::vector<unsigned int> breaks;
+  balanced_row_bands(cost, parts, breaks);
+
+  Rcpp::NumericVector part_cost(breaks.size() - 1);
+  for (size_t k = 0; k + 1 < breaks.size(); k++) {
+    for (unsigned int r = breaks[k]; r < breaks[k + 1]; r++) part_cost[k] += cost[r];
+  }
+  return Rcpp::List::create(Rcpp::Named("breaks") = Rcpp::wrap(breaks),
+                            Rcpp::Named("cost") = part_cost);
+}
+
+// Rasterize the rows of one part of a plan
+//
+// @param sf an [sf::sf()] object with a geometry column of POLYGON and/or
+// MULTIPOLYGON objects.
+// @param extent numeric vector c(xmin, xmax, ymin , ymax)
+// @param dimension integer vector c(ncol, nrow)
+// @param breaks integer row breaks from plan_row_bands()
+// @param part zero-based part to burn
+// @param path if not empty, spans are written to this span file rather than
+// returned
+// @return list of records (xstart, xend, row, poly_id) of the part's rows in
+// feature order, or the path of the span file
+// [[Rcpp::export]]
+SEXP burn_polygon_part(Rcpp::DataFrame &sf,
+                       Rcpp::NumericVector &extent,
+                       Rcpp::IntegerVector &dimension,
+                       Rcpp::IntegerVector &breaks,
+                       int part,
+                       std::string path = "") {
+  Rcpp::List polygons;
+  check_inputs_polygon(sf, polygons);  // Also fills in polygons
+  RasterInfo ras(extent, dimension);
+  std::vector<unsigned int> row_breaks(breaks.begin(), breaks.end());
+  check_row_breaks(row_breaks, ras.nrow);
+  RowBands bands(row_breaks, ras.nrow);
+  if (part < 0 || part >= (int)bands.size()) Rcpp::stop("part must be from 0 to %i", (int)bands.size() - 1);
+
+  std::vector<Feature> features;
+  features_from_list(polygons, features);
+  std::vector<bool> own(bands.size(), false);
+  own[part] = true;
+  std::vector<uint64_t> counts(features.size() * bands.size(), 0);
+  std::vector< std::vector<Span> > band_spans;
+  burn_bands(features, ras, bands, own, band_spans, counts.data());
+
+  if (path.empty()) return spans_to_list(band_spans[part]);
+  SpanFileWriter file;
+  if (!file.open(path, ras.ncol, ras.nrow)) Rcpp::stop("cannot open span file for writing");
+  file.write(band_spans[part].data(), band_spans[part].size());
+  if (!file.close()) Rcpp::stop("failed writing span file");
+  return Rcpp::wrap(path);
+}
+
+// Sequential reader of the records of one span file
+class SpanFileCursor {
+public:
+  SpanFileCursor() : file_(NULL), left_(0) {}
+  ~SpanFileCursor() { if (file_ != NULL) std::fclose(file_); }
+
+  bool open(const std::string &path, unsigned int &ncol, unsigned int &nrow) {
+    file_ = std::fopen(path.c_str(), "rb");
+    return file_ != NULL && read_spanfile_header(file_, ncol, nrow, left_);
+  }
+  // Move to the next record, false at the end
+  bool next() {
+    if (left_ == 0) return false;
+    int32_t rec[4];
+    if (std::fread(rec, sizeof(int32_t), 4, file_) != 4) Rcpp::stop("span file is truncated");
+    span = Span(rec[0], rec[1], rec[2], rec[3]);
+    left_--;
+    return true;
+  }
+  Span span;
+
+private:
+  FILE *file_;
+  uint64_t left_;
+};
+
+// Merge the span files of the parts of a plan into one
+//
+// Parts hold the rows of their band in feature order, so for each feature
+// in turn the records of every part are copied in part order, streaming with
+// one record per part in memory.
+//
+// @param paths span files of the parts, in part order
+// @param path span file to write
+// @return path, the spans in the order of burn_polygon()
+// [[Rcpp::export]]
+std::string merge_spanfiles(Rcpp::CharacterVector &paths, std::string path) {
+  size_t nparts = paths.size();
+  std::vector<SpanFileCursor> parts(nparts);
+  std::vector<bool> more(nparts);
+  unsigned int ncol = 0, nrow = 0;
+  for (size_t p = 0; p < nparts; p++) {
+    unsigned int pc, pr;
+    if (!parts[p].open(Rcpp::as<std::string>(paths[p]), pc, pr)) Rcpp::stop("cannot read span file %i", (int)p + 1);
+    if (p > 0 && (pc != ncol || pr != nrow)) Rcpp::stop("span files have different dimensions");
+    ncol = pc;
+    nrow = pr;
+    more[p] = parts[p].next();
+  }
+
+  SpanFileWriter out;
+  if (!out.open(path, ncol, nrow)) Rcpp::stop("cannot open span file for writing");
+  for (;;) {
+    //the lowest feature still to come
+    bool any = false;
+    unsigned int feature = 0;
+    for (size_t p = 0; p < nparts; p++) {
+      if (more[p] && (!any || parts[p].span.poly_id < feature)) feature = parts[p].span.poly_id;
+      any = any || more[p];
+    }
+    if (!any) break;
+    for (size_t p = 0; p < nparts; p++) {
+      while (more[p] && parts[p].span.poly_id == feature) {
+        out.write(&parts[p].span, 1);
+        more[p] = parts[p].next();
+      }
+    }
+  }
+  if (!out.close()) Rcpp::stop("failed writing span file");
+  return path;
+}
+
+struct less_by_poly_id {
+  inline bool operator() (const Span& span1, const Span& span2) {
+    return span1.poly_id < span2.poly_id;
+  }
+};
+
+// Merge the indexes of the parts of a plan into one
+//
+// @param parts list of indexes from burn_polygon_part(), in part order
+// @return list of records (xstart, xend, row, poly_id) as from burn_polygon()
+// [[Rcpp::export]]
+Rcpp::List merge_span_lists(Rcpp::List &parts) {
+  std::vector<Span> spans;
+  for (R_xlen_t p = 0; p < parts.size(); p++) {
+    Rcpp::List index = parts[p];
+    std::vector<const int *> records;
+    index_records(index, 4, records);
+    for (size_t i = 0; i < records.size(); i++) {
+      const int *rec = records[i];
+      spans.push_back(Span(rec[0], rec[1], rec[2], rec[3]));
+    }
+  }
+  //parts keep their order within each feature
+  std::stable_sort(spans.begin(), spans.end(), less_by_poly_id());
+  return spans_to_list(spans);
+}
@@ -0,0 +1,195 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "edge.h"
+
+#include "edgelist.h"
+#include "rasterize.h"
+#include "queue.h"
+#include "spanfile.h"
+#include "wkb.h"
+#include "trace.h"
+
+#include <map>
+#include <mutex>
+
+// Pipelined burn of WKB polygons
+//
+// One thread decodes WKB into edge lists, a pool of workers sweeps them and
+// the calling thread writes spans in feature order, the stages connected by
+// bounded lock-free queues. Decoding never runs more than queue_depth
+// features ahead of the writer, so memory stays bounded however many
+// features stream through.
+
+struct PipelineTask {
+  long index;  // -1 tells a worker to finish
+  std::list<Edge_polygon> *edges;
+};
+
+struct PipelineResult {
+  long index;  // -1 when a worker has finished
+  std::vector<Span> *spans;
+};
+
+typedef std::pair<const unsigned char *, size_t> WKBBuffer;
+
+class BurnPipeline {
+public:
+  BurnPipeline(std::vector<WKBBuffer> &inputs, RasterInfo &ras, int workers, int depth) :
+    inputs_(inputs), ras_(ras), nworkers_(workers), depth_(depth),
+    tasks_(depth), results_(depth), written_(0), failed_(false) {}
+
+  // Run all stages, handing spans to out (or file when it is open) in feature order
+  void run(std::vector<Span> &out, SpanFileWriter *file) {
+    std::vector<std::thread> threads;
+    threads.push_back(std::thread(&BurnPipeline::parse, this));
+    for (int w = 0; w < nworkers_; w++) {
+      threads.push_back(std::thread(&BurnPipeline::rasterize, this));
+    }
+    write(out, file);
+    for (size_t t = 0; t < threads.size(); t++) threads[t].join();
+  }
+
+  bool failed() const { return failed_; }
+  const std::string &error() const { return error_; }
+
+private:
+  std::vector<WKBBuffer> &inputs_;
+  RasterInfo ras_;
+  int nworkers_;
+  size_t depth_;
+  BoundedQueue<PipelineTask> tasks_;
+  BoundedQueue<PipelineResult> results_;
+  std::atomic<size_t> written_;
+  std::atomic<bool> failed_;
+  std::mutex error_mutex_;
+  std::string error_;
+
+  void fail(const std::string &msg) {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    if (!failed_) error_ = msg;
+    failed_ = true;
+  }
+
+  // Stage 1, decode and build edges
+  void parse() {
+    for (size_t i = 0; i < inputs_.size() && !failed_; i++) {
+      while (i >= written_ + depth_ && !failed_) std::this_thread::yield();
+      try {
+        TRACE_SCOPE("decode", i);
+        Feature feature;
+        feature_from_wkb(inputs_[i].first, inputs_[i].second, feature);
+        PipelineTask task = {(long)i, new std::list<Edge_polygon>()};
+        edgelist_feature(feature, ras_, *task.edges);
+        tasks_.push(task);
+      } catch (std::exception &e) {
+        fail(e.what());
+      }
+    }
+    for (int w = 0; w < nworkers_; w++) {
+      PipelineTask done = {-1, NULL};
+      tasks_.push(done);
+    }
+  }
+
+  // Stage 2, sweep edges into spans
+  void rasterize() {
+    PipelineTask task;
+    for (;;) {
+      tasks_.pop(task);
+      if (task.index < 0) break;
+      PipelineResult result = {task.index, NULL};
+      try {
+        if (!failed_) {
+          TRACE_SCOPE("sweep", task.index);
+          result.spans = new std::vector<Span>();
+          scan_polygon_edges(*task.edges, ras_, *result.spans, task.index);
+        }
+      } catch (std::exception &e) {
+        fail(e.what());
+      }
+      delete task.edges;
+      results_.push(result);
+    }
+    PipelineResult done = {-1, NULL};
+    results_.push(done);
+  }
+
+  // Stage 3, restore feature order and emit
+  void write(std::vector<Span> &out, SpanFileWriter *file) {
+    std::map<long, std::vector<Span> *> pending;
+    PipelineResult result;
+    int finished = 0;
+    size_t next = 0;
+    while (finished < nworkers_) {
+      results_.pop(result);
+      if (result.index < 0) {
+        finished++;
+        continue;
+      }
+      pending[result.index] = result.spans;
+      while (!pending.empty() && pending.begin()->first == (long)next) {
+        std::vector<Span> *spans = pending.begin()->second;
+        if (spans != NULL && !failed_) {
+          if (file != NULL) {
+            file->write(spans->data(), spans->size());
+          } else {
+            out.insert(out.end(), spans->begin(), spans->end());
+          }
+        }
+        delete spans;
+        pending.erase(pending.begin());
+        written_ = ++next;
+      }
+    }
+    for (std::map<long, std::vector<Span> *>::iterator it = pending.begin(); it != pending.end(); ++it) {
+      delete it->second;
+    }
+  }
+};
+
+// Burn WKB polygons through a parse, rasterize, write pipeline
+//
+// @param wkb list of raw vectors of WKB POLYGON or MULTIPOLYGON (such as from
+// sf::st_as_binary() or wk::wkb())
+// @param extent numeric vector c(xmin, xmax, ymin , ymax)
+// @param dimension integer vector c(ncol, nrow)
+// @param workers number of rasterizing threads
+// @param queue_depth capacity of the queues between stages, and the most
+// features in flight at once
+// @param path if not empty, spans are streamed to this binary span file
+// (see read_spanfile()) rather than returned
+// @return list of records (xstart, xend, row, poly_id) as from burn_polygon(),
+// or the path of the span file
+// [[Rcpp::export]]
+SEXP burn_wkb_pipeline(Rcpp::List &wkb,
+                       Rcpp::NumericVector &extent,
+                       Rcpp::IntegerVector &dimension,
+                       int workers = 2,
+                       int queue_depth = 64,
+                       std::string path = "") {
+  std::vector<WKBBuffer> inputs(wkb.size());
+  for (R_xlen_t i = 0; i < wkb.size(); i++) {
+    SEXP el = wkb[i];
+    if (TYPEOF(el) != RAWSXP) Rcpp::stop("wkb must be a list of raw vectors");
+    inputs[i] = WKBBuffer(RAW(el), Rf_xlength(el));
+  }
+  workers = std::max(workers, 1);
+  queue_depth = std::max(queue_depth, 2 * workers);
+
+  RasterInfo ras(extent, dimension);
+  std::vector<Span> spans;
+  SpanFileWriter file;
+  if (!path.empty() && !file.open(path, ras.ncol, ras.nrow)) {
+    Rcpp::stop("cannot open span file for writing");
+  }
+
+  BurnPipeline pipeline(inputs, ras, workers, queue_depth);
+  pipeline.run(spans, path.empty() ? NULL : &file);
+  if (pipeline.failed()) Rcpp::stop(pipeline.error());
+
+  if (!path.empty()) {
+    if (!file.close()) Rcpp::stop("failed writing span file");
+    return Rcpp::wrap(path);
+  }
+  return spans_to_list(spans);
+}
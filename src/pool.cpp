@@ -0,0 +1,210 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "pool.h"
+#include "trace.h"
+
+#include <cstdlib>
+#include <exception>
+#include <stdexcept>
+
+TaskPool::TaskPool() : queued_(0), next_queue_(0), inline_cost_(50000), active_calls_(0), stop_(false) {}
+
+TaskPool::~TaskPool() {
+  stop_workers();
+}
+
+TaskPool &TaskPool::instance() {
+  static TaskPool pool;
+  return pool;
+}
+
+void TaskPool::stop_workers() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (size_t i = 0; i < threads_.size(); i++) threads_[i].join();
+  threads_.clear();
+  queues_.clear();
+  stop_ = false;
+}
+
+void TaskPool::resize(int nthreads) {
+  std::lock_guard<std::mutex> lock(config_mutex_);
+  nthreads = std::max(nthreads, 1);
+  //busy pools keep their size until the next call finds them idle
+  if (nthreads == size() || active_calls_ > 0) return;
+  stop_workers();
+  for (int i = 0; i < nthreads - 1; i++) {
+    queues_.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+  }
+  for (int i = 0; i < nthreads - 1; i++) {
+    threads_.push_back(std::thread(&TaskPool::worker, this, i));
+  }
+}
+
+double TaskPool::inline_cost() {
+  std::lock_guard<std::mutex> lock(config_mutex_);
+  return inline_cost_;
+}
+
+void TaskPool::set_inline_cost(double cost) {
+  std::lock_guard<std::mutex> lock(config_mutex_);
+  inline_cost_ = cost;
+}
+
+void TaskPool::push(const Task &task) {
+  WorkQueue &queue = *queues_[next_queue_++ % queues_.size()];
+  {
+    //counted under the queue's lock, so take() can't count it off first
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(task);
+    queued_++;
+  }
+  {
+    //a worker between checking queued_ and sleeping is woken too
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+  }
+  wake_.notify_one();
+}
+
+// Own work from the back, stolen work from the front of the others
+bool TaskPool::take(size_t self, Task &task) {
+  size_t n = queues_.size();
+  for (size_t k = 0; k < n; k++) {
+    size_t q = (self + k) % n;
+    WorkQueue &queue = *queues_[q];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) continue;
+    if (q == self) {
+      task = queue.tasks.back();
+      queue.tasks.pop_back();
+    } else {
+      task = queue.tasks.front();
+      queue.tasks.pop_front();
+    }
+    queued_--;
+    return true;
+  }
+  return false;
+}
+
+void TaskPool::worker(size_t self) {
+  Task task;
+  for (;;) {
+    if (take(self, task)) {
+      task();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    wake_.wait(lock, [this] { return stop_ || queued_ > 0; });
+    if (stop_) return;
+  }
+}
+
+void TaskPool::parallel_for(size_t n, double cost, const std::function<void(size_t, size_t)> &body) {
+  if (n == 0) return;
+  bool run_inline;
+  {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    run_inline = queues_.empty() || n == 1 || cost < inline_cost_;
+    if (!run_inline) active_calls_++;
+  }
+  if (run_inline) {
+    body(0, n);
+    return;
+  }
+
+  //a few chunks per thread so stealing can even out uneven chunks
+  size_t nchunk = std::min(n, (size_t)size() * 4);
+  std::atomic<size_t> remaining(nchunk);
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  for (size_t c = 0; c < nchunk; c++) {
+    size_t begin = n * c / nchunk, end = n * (c + 1) / nchunk;
+    push([&, begin, end] {
+      try {
+        TRACE_SCOPE("chunk", begin);
+        body(begin, end);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) error = std::current_exception();
+      }
+      remaining--;
+    });
+  }
+  //the caller works too, until its own chunks are all done
+  Task task;
+  size_t self = next_queue_ % queues_.size();
+  while (remaining > 0) {
+    if (take(self, task)) {
+      task();
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    active_calls_--;
+  }
+  if (error) std::rethrow_exception(error);
+}
+
+TaskPool &task_pool() {
+  int nthreads = 0;
+  SEXP option = Rf_GetOption1(Rf_install("controlledburn.threads"));
+  const char *env = std::getenv("CONTROLLEDBURN_NUM_THREADS");
+  if (!Rf_isNull(option)) {
+    nthreads = Rf_asInteger(option);
+  } else if (env != NULL) {
+    nthreads = std::atoi(env);
+  }
+  if (nthreads == NA_INTEGER || nthreads < 1) {
+    nthreads = std::max((int)std::thread::hardware_concurrency(), 1);
+  }
+  TaskPool &pool = TaskPool::instance();
+  pool.resize(nthreads);
+  return pool;
+}
+
+// Set the work below which parallel calls run on the calling thread
+//
+// @param cost work in the units of the burns' estimates, roughly edges plus
+// rows swept, or NULL to leave it
+// @return the previous setting
+// [[Rcpp::export]]
+double pool_inline_cost(SEXP cost = R_NilValue) {
+  TaskPool &pool = task_pool();
+  double old = pool.inline_cost();
+  if (!Rf_isNull(cost)) pool.set_inline_cost(Rf_asReal(cost));
+  return old;
+}
+
+// Check the pool with nested parallel loops
+//
+// Runs an outer loop of n indexes each running an inner loop of m, every
+// chunk handed to the pool whatever its cost, and counts the visits of each
+// inner index. With fail at or above zero, inner index fail throws.
+//
+// @param n outer indexes
+// @param m inner indexes of each
+// @param fail inner index to fail at, -1 for none
+// @return integer vector of n * m visit counts, all 1 when the pool is sound
+// [[Rcpp::export]]
+Rcpp::IntegerVector pool_selftest(int n, int m, int fail = -1) {
+  if (n < 0 || m < 0) Rcpp::stop("n and m must not be negative");
+  TaskPool &pool = task_pool();
+  std::vector<int> visits((size_t)n * m, 0);
+  pool.parallel_for(n, R_PosInf, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      pool.parallel_for(m, R_PosInf, [&, i](size_t b, size_t e) {
+        for (size_t j = b; j < e; j++) {
+          if ((long)(i * m + j) == fail) throw std::runtime_error("task " + std::to_string(fail) + " failed");
+          visits[i * m + j]++;
+        }
+      });
+    }
+  });
+  return Rcpp::wrap(visits);
+}
@@ -0,0 +1,69 @@
+#ifndef TASK_POOL
+#define TASK_POOL
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Process-wide persistent pool of native worker threads
+//
+// Each worker owns a deque: it takes its own work from the back and steals
+// from the front of the others when it runs dry, then sleeps until new work
+// arrives. parallel_for() splits a range into chunks, spreads them over the
+// deques and has the calling thread work through them too, so calls can be
+// nested or made from several threads at once. Work estimated below
+// inline_cost runs directly on the caller with no hand-off at all.
+//
+// Tasks must not call the R API, only the thread that called into R may.
+class TaskPool {
+public:
+  typedef std::function<void()> Task;
+
+  static TaskPool &instance();
+
+  // Total threads including the caller, resizing waits for idle
+  void resize(int nthreads);
+  int size() const { return (int)threads_.size() + 1; }
+
+  // Run body(begin, end) over chunks of [0, n)
+  void parallel_for(size_t n, double cost, const std::function<void(size_t, size_t)> &body);
+
+  // Work below which parallel_for() runs on the caller
+  double inline_cost();
+  void set_inline_cost(double cost);
+
+private:
+  struct WorkQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  std::vector<std::unique_ptr<WorkQueue> > queues_;
+  std::vector<std::thread> threads_;
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  std::atomic<size_t> queued_;
+  std::atomic<size_t> next_queue_;
+  std::mutex config_mutex_;
+  double inline_cost_;
+  int active_calls_;
+  bool stop_;
+
+  TaskPool();
+  ~TaskPool();
+  void push(const Task &task);
+  bool take(size_t self, Task &task);
+  void worker(size_t self);
+  void stop_workers();
+};
+
+// Configure the pool from option "controlledburn.threads" or else the
+// environment variable CONTROLLEDBURN_NUM_THREADS, call on the R thread
+extern TaskPool &task_pool();
+
+#endif
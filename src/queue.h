@@ -0,0 +1,95 @@
+#ifndef BOUNDED_QUEUE
+#define BOUNDED_QUEUE
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Bounded multi-producer multi-consumer queue without locks
+//
+// After Dmitry Vyukov's array queue: each cell carries a sequence number that
+// tells producers and consumers whether it is free for their lap of the ring,
+// so a push or pop is one compare-and-swap on the shared position. The
+// blocking push() and pop() spin then yield while the queue is full or empty.
+template <class T>
+class BoundedQueue {
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T data;
+  };
+
+public:
+  BoundedQueue(size_t size) : mask_(0), enqueue_pos_(0), dequeue_pos_(0) {
+    size_t capacity = 2;
+    while (capacity < size) capacity *= 2;
+    std::vector<Cell> buffer(capacity);
+    buffer_.swap(buffer);
+    mask_ = capacity - 1;
+    for (size_t i = 0; i < capacity; i++) {
+      buffer_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  bool try_push(const T &data) {
+    Cell *cell;
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      cell = &buffer_[pos & mask_];
+      size_t seq = cell->sequence.load(std::memory_order_acquire);
+      long dif = (long)seq - (long)pos;
+      if (dif == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (dif < 0) {
+        return false;  // full
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->data = data;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_pop(T &data) {
+    Cell *cell;
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      cell = &buffer_[pos & mask_];
+      size_t seq = cell->sequence.load(std::memory_order_acquire);
+      long dif = (long)seq - (long)(pos + 1);
+      if (dif == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (dif < 0) {
+        return false;  // empty
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    data = cell->data;
+    cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+    return true;
+  }
+
+  void push(const T &data) {
+    for (unsigned int spin = 0; !try_push(data); spin++) backoff(spin);
+  }
+
+  void pop(T &data) {
+    for (unsigned int spin = 0; !try_pop(data); spin++) backoff(spin);
+  }
+
+private:
+  std::vector<Cell> buffer_;
+  size_t mask_;
+  char pad0_[64];
+  std::atomic<size_t> enqueue_pos_;
+  char pad1_[64];
+  std::atomic<size_t> dequeue_pos_;
+  char pad2_[64];
+
+  static void backoff(unsigned int spin) {
+    if (spin > 64) std::this_thread::yield();
+  }
+};
+
+#endif
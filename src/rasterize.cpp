@@ -1,25 +1,54 @@
 #include "edge.h"
 #include "edgelist.h"
 #include "rasterize.h"
+#include "trace.h"
 
 // Rasterize a single polygon
 // Based on https://ezekiel.encs.vancouver.wsu.edu/~cs442/lectures/rasterization/polyfill/polyfill.pdf #nolint
 
-void record_polygon_scanline(CollectorList &out_vector, unsigned int xs, unsigned int xe, unsigned int y, unsigned int poly_id) {
+void record_polygon_scanline(std::vector<Span> &spans, unsigned int xs, unsigned int xe, unsigned int y, unsigned int poly_id) {
   if (xs == xe) return;
-  out_vector.push_back(Rcpp::IntegerVector::create(xs, xe - 1, y, poly_id));
+  spans.push_back(Span(xs, xe - 1, y, poly_id));
   return;
 }
-void rasterize_polygon(Rcpp::RObject polygon,
-                       RasterInfo &ras, CollectorList &out_vector, unsigned int poly_id) {
+
+// Limit an edge list to the rows [row0, row1) of a window
+//
+// Edges wholly outside the window are dropped, and those starting above it
+// are stepped down to row0 by the same additions the sweep makes from row to
+// row, not one multiply, so their x on every row of the window rounds exactly
+// as in a sweep of all rows.
+static void window_edges(std::list<Edge_polygon> &edges, unsigned int row0, unsigned int row1) {
+  if (row0 == 0 && row1 == UINT_MAX) return;
+  std::list<Edge_polygon>::iterator it = edges.begin();
+  while (it != edges.end()) {
+    if ((*it).yend <= row0 || (*it).ystart >= row1) {
+      it = edges.erase(it);
+      continue;
+    }
+    for (; (*it).ystart < row0; (*it).ystart++) (*it).x += (*it).dxdy;
+    it++;
+  }
+}
+
+// Sweep a prepared edge list, appending the spans of every row it covers
+//
+// With a SweepCheck the order of the active edges is checked after stepping
+// them to the next row: an edge that has passed its neighbour crossed it
+// between the rows, so the ring self-intersects (or rings overlap) and the
+// row is recorded. It costs one comparison per active edge per row. The
+// check can also ask for the nonzero winding rule in place of even-odd.
+void scan_polygon_edges(std::list<Edge_polygon> &edges,
+                        RasterInfo &ras, std::vector<Span> &spans, unsigned int poly_id,
+                        SweepCheck *check, unsigned int row0, unsigned int row1) {
 
   std::list<Edge_polygon>::iterator it;
   unsigned int counter, xstart, xend; //, xpix;
   xstart = 0;
 
-  //Create the list of all edges of the polygon, fill and sort it
-  std::list<Edge_polygon> edges;
-  edgelist_polygon(polygon, ras, edges);
+  window_edges(edges, row0, row1);
+  if (edges.empty()) return;
+  unsigned int nrow = std::min(ras.nrow, row1);
   edges.sort(less_by_ystart());
 
   // Initialize an empty list of "active" edges
@@ -30,7 +59,7 @@ void rasterize_polygon(Rcpp::RObject polygon,
 
   //Main loop
   while(
-    (yline < ras.nrow) &&
+    (yline < nrow) &&
       (!(active_edges.empty() && edges.empty()))
   ) {
     // Transfer any edges starting on this row from edges to active edges
@@ -40,18 +69,35 @@ void rasterize_polygon(Rcpp::RObject polygon,
     //Sort active edges by x position of their intersection with the row
     active_edges.sort(less_by_x());
 
-    //Iterate over active edges, fill between odd and even edges.
-    counter = 0;
-    for(it = active_edges.begin();
-        it != active_edges.end();
-        it++) {
-      counter++;
-      if (counter % 2) {
-        xstart = ((*it).x < 0.0) ? 0.0 : ((*it).x >= ras.ncold ? (ras.ncold -1) : std::ceil((*it).x));
-      } else {
-        xend = ((*it).x < 0.0) ?  0.0 : ((*it).x >= ras.ncold ? (ras.ncold -1) : std::ceil((*it).x));
-        record_polygon_scanline(out_vector, xstart, xend, yline, poly_id);
+    if (check != NULL && check->nonzero) {
+      //Fill where the winding number of the edges to the left is not zero
+      int winding = 0;
+      for(it = active_edges.begin();
+          it != active_edges.end();
+          it++) {
+        int before = winding;
+        winding += (*it).winding;
+        if (before == 0 && winding != 0) {
+          xstart = ((*it).x < 0.0) ? 0.0 : ((*it).x >= ras.ncold ? (ras.ncold -1) : std::ceil((*it).x));
+        } else if (before != 0 && winding == 0) {
+          xend = ((*it).x < 0.0) ?  0.0 : ((*it).x >= ras.ncold ? (ras.ncold -1) : std::ceil((*it).x));
+          record_polygon_scanline(spans, xstart, xend, yline, poly_id);
+        }
+      }
+    } else {
+      //Iterate over active edges, fill between odd and even edges.
+      counter = 0;
+      for(it = active_edges.begin();
+          it != active_edges.end();
+          it++) {
+        counter++;
+        if (counter % 2) {
+          xstart = ((*it).x < 0.0) ? 0.0 : ((*it).x >= ras.ncold ? (ras.ncold -1) : std::ceil((*it).x));
+        } else {
+          xend = ((*it).x < 0.0) ?  0.0 : ((*it).x >= ras.ncold ? (ras.ncold -1) : std::ceil((*it).x));
+          record_polygon_scanline(spans, xstart, xend, yline, poly_id);
 
+        }
       }
     }
     //Advance the horizontal row
@@ -68,6 +114,165 @@ void rasterize_polygon(Rcpp::RObject polygon,
         it++;
       }
     }
+
+    //Edges still in order unless two of them crossed
+    if (check != NULL && yline < nrow && active_edges.size() > 1) {
+      std::list<Edge_polygon>::iterator prev = active_edges.begin();
+      for(it = ++active_edges.begin(); it != active_edges.end(); prev = it, it++) {
+        if ((*it).x < (*prev).x) {
+          check->rows.push_back(yline);
+          break;
+        }
+      }
+    }
+  }
+}
+
+// Sweep a prepared edge list from a table rather than linked lists
+//
+// Edges are sorted once by starting row into a vector and taken from it in
+// order, and the active edges are a vector kept in x order by insertion
+// sort: from one row to the next they are nearly in order already, so that
+// is close to linear where sorting the list is n log n on every row. Ties
+// keep their order as the list's stable sort does, so the spans are the
+// same as from scan_polygon_edges().
+void scan_polygon_table(std::list<Edge_polygon> &edges,
+                        RasterInfo &ras, std::vector<Span> &spans, unsigned int poly_id,
+                        unsigned int row0, unsigned int row1) {
+  window_edges(edges, row0, row1);
+  if (edges.empty()) return;
+  unsigned int nrow = std::min(ras.nrow, row1);
+  std::vector<Edge_polygon> table(edges.begin(), edges.end());
+  std::stable_sort(table.begin(), table.end(), less_by_ystart());
+  std::vector<Edge_polygon> active;
+  size_t next = 0;
+  unsigned int xstart = 0, xend;
+
+  unsigned int yline(table.front().ystart);
+  while ((yline < nrow) && (!(active.empty() && next == table.size()))) {
+    while (next < table.size() && table[next].ystart <= yline) {
+      active.push_back(table[next++]);
+    }
+    for (size_t i = 1; i < active.size(); i++) {
+      if (!(active[i].x < active[i - 1].x)) continue;
+      Edge_polygon edge = active[i];
+      size_t j = i;
+      for (; j > 0 && edge.x < active[j - 1].x; j--) active[j] = active[j - 1];
+      active[j] = edge;
+    }
+
+    //fill between odd and even edges
+    for (size_t i = 0; i < active.size(); i++) {
+      long double x = active[i].x;
+      unsigned int xs = (x < 0.0) ? 0.0 : (x >= ras.ncold ? (ras.ncold -1) : std::ceil(x));
+      if (i % 2 == 0) {
+        xstart = xs;
+      } else {
+        xend = xs;
+        record_polygon_scanline(spans, xstart, xend, yline, poly_id);
+      }
+    }
+    yline++;
+
+    //drop finished edges in place, step the rest to the next row
+    size_t n = 0;
+    for (size_t i = 0; i < active.size(); i++) {
+      if (active[i].yend <= yline) continue;
+      active[i].x += active[i].dxdy;
+      active[n++] = active[i];
+    }
+    active.erase(active.begin() + n, active.end());
+  }
+}
+
+EngineTuning &engine_tuning() {
+  static EngineTuning tuning;
+  return tuning;
+}
+
+PolygonEngine polygon_engine(const std::string &name) {
+  if (name == "auto") return ENGINE_AUTO;
+  if (name == "list") return ENGINE_LIST;
+  if (name == "table") return ENGINE_TABLE;
+  Rcpp::stop("engine must be one of \"auto\", \"list\" or \"table\"");
+}
+
+// Pick an engine for one feature from the mean number of edges starting on
+// each row it covers, which is what the table's insertion sort grows with
+PolygonEngine choose_engine(const std::list<Edge_polygon> &edges) {
+  if (edges.empty()) return ENGINE_LIST;
+  unsigned int top = edges.front().ystart, bottom = edges.front().yend;
+  for (std::list<Edge_polygon>::const_iterator it = edges.begin(); it != edges.end(); ++it) {
+    top = std::min(top, (*it).ystart);
+    bottom = std::max(bottom, (*it).yend);
+  }
+  double per_row = (double)edges.size() / std::max(bottom - top, 1u);
+  return (per_row >= engine_tuning().list_edges) ? ENGINE_LIST : ENGINE_TABLE;
+}
+
+void rasterize_polygon(Rcpp::RObject polygon,
+                       RasterInfo &ras, std::vector<Span> &spans, unsigned int poly_id) {
+  //Create the list of all edges of the polygon, and sweep it
+  std::list<Edge_polygon> edges;
+  edgelist_polygon(polygon, ras, edges);
+  scan_polygon_edges(edges, ras, spans, poly_id);
+}
+
+void rasterize_feature(const Feature &feature,
+                       RasterInfo &ras, std::vector<Span> &spans, unsigned int poly_id,
+                       PolygonEngine engine, unsigned int row0, unsigned int row1) {
+  std::list<Edge_polygon> edges;
+  edgelist_feature(feature, ras, edges);
+  window_edges(edges, row0, row1);
+  if (engine == ENGINE_AUTO) engine = choose_engine(edges);
+  if (engine == ENGINE_TABLE) {
+    scan_polygon_table(edges, ras, spans, poly_id, row0, row1);
+  } else {
+    scan_polygon_edges(edges, ras, spans, poly_id, NULL, row0, row1);
+  }
+}
+
+// Rough work of sweeping a feature, its edges plus the rows it spans
+double feature_cost(const Feature &feature, RasterInfo &ras) {
+  double ymin = ras.ymax, ymax = ras.ymin, n = 0;
+  for(Feature::const_iterator ring = feature.begin(); ring != feature.end(); ++ring) {
+    n += (*ring).y.size();
+    for(size_t i = 0; i < (*ring).y.size(); i++) {
+      ymin = std::min(ymin, (*ring).y[i]);
+      ymax = std::max(ymax, (*ring).y[i]);
+    }
+  }
+  return n + std::max(std::min(ymax, ras.ymax) - std::max(ymin, ras.ymin), 0.0)/ras.yres;
+}
+
+// Rasterize features across the task pool, spans come out in feature order
+void rasterize_features(const std::vector<Feature> &features,
+                        RasterInfo &ras, std::vector<Span> &spans, TaskPool &pool,
+                        PolygonEngine engine) {
+  std::vector< std::vector<Span> > parts(features.size());
+  double cost = 0;
+  for (size_t i = 0; i < features.size(); i++) cost += feature_cost(features[i], ras);
+  pool.parallel_for(features.size(), cost, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      TRACE_SCOPE("sweep", i);
+      rasterize_feature(features[i], ras, parts[i], i, engine);
+    }
+  });
+  size_t n = spans.size();
+  for (size_t i = 0; i < parts.size(); i++) n += parts[i].size();
+  spans.reserve(n);
+  for (size_t i = 0; i < parts.size(); i++) {
+    spans.insert(spans.end(), parts[i].begin(), parts[i].end());
+  }
+}
+
+void rasterize_polygon(Rcpp::RObject polygon,
+                       RasterInfo &ras, CollectorList &out_vector, unsigned int poly_id) {
+  std::vector<Span> spans;
+  rasterize_polygon(polygon, ras, spans, poly_id);
+  for (std::vector<Span>::iterator sp = spans.begin(); sp != spans.end(); ++sp) {
+    out_vector.push_back(Rcpp::IntegerVector::create((*sp).xstart, (*sp).xend,
+                                                     (*sp).row, (*sp).poly_id));
   }
 }
 
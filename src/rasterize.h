@@ -4,11 +4,58 @@
 #include "edge.h"
 #include "Rcpp.h"
 #include "CollectorList.h"
+#include "span.h"
+#include "geometry.h"
+#include "pool.h"
+#include <climits>
 
 using namespace Rcpp;
 
+extern void record_polygon_scanline(std::vector<Span> &spans, unsigned int xs, unsigned int xe,
+                                   unsigned int y, unsigned int poly_id);
+// Optional checking for scan_polygon_edges(), rows where active edges crossed
+struct SweepCheck {
+  bool nonzero;  // fill by nonzero winding instead of even-odd
+  std::vector<unsigned int> rows;
+  SweepCheck() : nonzero(false) {}
+};
+
+// Both sweeps can be limited to the rows [row0, row1) of a window, giving the
+// spans of the full sweep on those rows without sweeping the others
+extern void scan_polygon_edges(std::list<Edge_polygon> &edges,
+                               RasterInfo &ras, std::vector<Span> &spans, unsigned int poly_id,
+                               SweepCheck *check = NULL,
+                               unsigned int row0 = 0, unsigned int row1 = UINT_MAX);
+extern void scan_polygon_table(std::list<Edge_polygon> &edges,
+                               RasterInfo &ras, std::vector<Span> &spans, unsigned int poly_id,
+                               unsigned int row0 = 0, unsigned int row1 = UINT_MAX);
+
+// Ways to sweep a polygon, all burning the same cells
+enum PolygonEngine {
+  ENGINE_AUTO,  // chosen per feature from engine_tuning()
+  ENGINE_LIST,  // scan_polygon_edges(), linked lists sorted every row
+  ENGINE_TABLE  // scan_polygon_table(), a sorted edge table and insertion sort
+};
+// Thresholds for ENGINE_AUTO until burn_calibrate() measures them
+struct EngineTuning {
+  double list_edges;  // mean edges starting per row from which the list wins
+  EngineTuning() : list_edges(64) {}
+};
+extern EngineTuning &engine_tuning();
+extern PolygonEngine polygon_engine(const std::string &name);
+extern PolygonEngine choose_engine(const std::list<Edge_polygon> &edges);
+extern void rasterize_polygon(Rcpp::RObject polygon,
+                              RasterInfo &ras, std::vector<Span> &spans, unsigned int poly_id);
 extern void rasterize_polygon(Rcpp::RObject polygon,
                               RasterInfo &ras, CollectorList &out_vector, unsigned int poly_id);
+extern void rasterize_feature(const Feature &feature,
+                              RasterInfo &ras, std::vector<Span> &spans, unsigned int poly_id,
+                              PolygonEngine engine = ENGINE_AUTO,
+                              unsigned int row0 = 0, unsigned int row1 = UINT_MAX);
+extern double feature_cost(const Feature &feature, RasterInfo &ras);
+extern void rasterize_features(const std::vector<Feature> &features,
+                               RasterInfo &ras, std::vector<Span> &spans, TaskPool &pool,
+                               PolygonEngine engine = ENGINE_AUTO);
 extern void rasterize_line(Rcpp::RObject polygon,
                               RasterInfo &ras, CollectorList &out_vector);
 #endif
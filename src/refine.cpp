@@ -0,0 +1,271 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "edge.h"
+#include "check_inputs.h"
+
+#include "edgelist.h"
+#include "rasterize.h"
+
+#include <map>
+
+// Refine a coarse polygon burn by an integer factor
+//
+// A coarse cell that no edge passes through is wholly in or out, so its
+// status from the coarse index holds for all factor x factor fine cells in
+// it and its span is simply scaled. Only runs of coarse cells touched by
+// edges are decided again at the fine resolution: a fine cell in such a run
+// takes the status of the clean coarse cell to the left of the run, flipped
+// at every edge crossing of its fine row within the run. Crossings are found
+// with the same edges, the same per-row x steps and the same ceil rule as
+// the sweep, so the cells match a full burn at the fine resolution. Coarse
+// rows are taken in order with only the edges active on them, and each fine
+// row's crossings, runs and clean spans are walked together in column order,
+// so the work follows the crossings and the spans written.
+
+typedef std::pair<long, long> Run;  // first and last column, inclusive
+
+struct RefineRow {
+  std::vector<Run> inside;    // coarse spans of the feature
+  std::vector<Run> boundary;  // coarse cells touched by an edge
+};
+
+struct Crossing {
+  unsigned int row;  // fine row
+  long double x;     // position along the row in fine cells
+  long coarse_col;   // coarse column the crossing falls in
+  unsigned int col;  // fine column as the sweep rounds it
+};
+
+// Rounded columns are not monotone in x at the right border, so crossings
+// are kept in x order as the sweep pairs them
+struct less_by_crossing_x {
+  inline bool operator() (const Crossing& c1, const Crossing& c2) {
+    return c1.x < c2.x;
+  }
+};
+
+// Sort and merge runs that overlap or touch
+void merge_runs(std::vector<Run> &runs) {
+  if (runs.empty()) return;
+  std::sort(runs.begin(), runs.end());
+  size_t k = 0;
+  for (size_t i = 1; i < runs.size(); i++) {
+    if (runs[i].first <= runs[k].second + 1) {
+      runs[k].second = std::max(runs[k].second, runs[i].second);
+    } else {
+      runs[++k] = runs[i];
+    }
+  }
+  runs.resize(k + 1);
+}
+
+// Mark the coarse cells each segment passes through, padded by a cell
+// either way so rounding can never leave an edge outside its run
+void mark_boundary(const Feature &feature, RasterInfo &ras, std::map<long, RefineRow> &rows) {
+  long ncol = ras.ncol, nrow = ras.nrow;
+  for(Feature::const_iterator ring = feature.begin(); ring != feature.end(); ++ring) {
+    const std::vector<double> &x = (*ring).x, &y = (*ring).y;
+    for(size_t i = 0; i + 1 < y.size(); ++i) {
+      double u0 = (x[i] - ras.xmin)/ras.xres, u1 = (x[i + 1] - ras.xmin)/ras.xres;
+      double v0 = (ras.ymax - y[i])/ras.yres, v1 = (ras.ymax - y[i + 1])/ras.yres;
+      double va = std::min(v0, v1), vb = std::max(v0, v1);
+      long r0 = std::max((long)std::floor(va) - 1, 0L);
+      long r1 = std::min((long)std::floor(vb) + 1, nrow - 1);
+      for (long r = r0; r <= r1; r++) {
+        double ua, ub;
+        if (va == vb) {
+          ua = u0;
+          ub = u1;
+        } else {
+          double vt = std::max(std::min((double)r, vb), va), vbot = std::max(std::min((double)r + 1, vb), va);
+          ua = u0 + (vt - v0) * (u1 - u0)/(v1 - v0);
+          ub = u0 + (vbot - v0) * (u1 - u0)/(v1 - v0);
+        }
+        long c0 = std::max((long)std::floor(std::min(ua, ub)) - 1, 0L);
+        long c1 = std::min((long)std::floor(std::max(ua, ub)) + 1, ncol - 1);
+        if (c0 > c1) {
+          //wholly left or right of the grid, edges there still count at the border
+          c0 = c1 = (std::max(ua, ub) < 0) ? 0 : ncol - 1;
+        }
+        rows[r].boundary.push_back(Run(c0, c1));
+      }
+    }
+  }
+}
+
+// Append a run in column order, joining it to the last one if they touch
+inline void push_run(std::vector<Run> &runs, long first, long last) {
+  if (!runs.empty() && first <= runs.back().second + 1) {
+    runs.back().second = std::max(runs.back().second, last);
+  } else {
+    runs.push_back(Run(first, last));
+  }
+}
+
+bool coarse_inside(std::vector<Run> &inside, long col) {
+  for (size_t i = 0; i < inside.size(); i++) {
+    if (inside[i].first <= col && col <= inside[i].second) return true;
+  }
+  return false;
+}
+
+void refine_feature(const Feature &feature, std::vector<const int *> &coarse,
+                    RasterInfo &ras, RasterInfo &fine, long factor,
+                    std::vector<Span> &spans, unsigned int poly_id) {
+  std::map<long, RefineRow> rows;
+  for (size_t i = 0; i < coarse.size(); i++) {
+    rows[coarse[i][2]].inside.push_back(Run(coarse[i][0], coarse[i][1]));
+  }
+  mark_boundary(feature, ras, rows);
+
+  //edges by starting row, made active as the coarse rows reach them
+  std::list<Edge_polygon> edges;
+  edgelist_feature(feature, fine, edges);
+  std::vector<Edge_polygon> table(edges.begin(), edges.end());
+  std::stable_sort(table.begin(), table.end(), less_by_ystart());
+  std::vector<Edge_polygon> active;
+  size_t next = 0;
+
+  //crossings of each fine row of the coarse row being refined
+  std::vector< std::vector<Crossing> > crossings(factor);
+  std::vector<Run> filled;
+  std::vector<unsigned int> local;
+  for (std::map<long, RefineRow>::iterator rit = rows.begin(); rit != rows.end(); ++rit) {
+    long R = rit->first;
+    RefineRow &row = rit->second;
+    unsigned int top = R * factor, bottom = std::min((unsigned int)((R + 1) * factor), fine.nrow);
+
+    //crossings of this row's fine rows by the edges active on them, stepping
+    //x down each edge row by row as the sweep does, through any rows not in
+    //the map too (mark_boundary() marks every coarse row a segment reaches,
+    //so no crossing is on them)
+    while (next < table.size() && table[next].ystart < bottom) active.push_back(table[next++]);
+    for (long i = 0; i < factor; i++) crossings[i].clear();
+    size_t n = 0;
+    for (size_t i = 0; i < active.size(); i++) {
+      Edge_polygon &edge = active[i];
+      for (; edge.ystart < top && edge.ystart < edge.yend; edge.ystart++) edge.x += edge.dxdy;
+      for (; edge.ystart < bottom && edge.ystart < edge.yend; edge.ystart++) {
+        long double x = edge.x;
+        Crossing cross;
+        cross.row = edge.ystart;
+        cross.x = x;
+        cross.col = (x < 0.0) ? 0.0 : (x >= fine.ncold ? (fine.ncold - 1) : std::ceil(x));
+        cross.coarse_col = std::max(std::min((long)std::floor((x + 0.5)/factor), (long)ras.ncol - 1), 0L);
+        crossings[edge.ystart - top].push_back(cross);
+        row.boundary.push_back(Run(cross.coarse_col, cross.coarse_col));
+        edge.x += edge.dxdy;
+      }
+      if (edge.ystart < edge.yend) active[n++] = edge;
+    }
+    active.erase(active.begin() + n, active.end());
+    merge_runs(row.inside);
+    merge_runs(row.boundary);
+
+    //clean parts of the coarse spans are the same on every fine row
+    std::vector<Run> clean;
+    for (size_t i = 0; i < row.inside.size(); i++) {
+      long a = row.inside[i].first, b = row.inside[i].second;
+      for (size_t k = 0; k < row.boundary.size() && a <= b; k++) {
+        if (row.boundary[k].second < a) continue;
+        if (row.boundary[k].first > b) break;
+        if (row.boundary[k].first > a) clean.push_back(Run(a * factor, row.boundary[k].first * factor - 1));
+        a = row.boundary[k].second + 1;
+      }
+      if (a <= b) clean.push_back(Run(a * factor, (b + 1) * factor - 1));
+    }
+    std::vector<bool> left_inside(row.boundary.size());
+    for (size_t k = 0; k < row.boundary.size(); k++) {
+      long c0 = row.boundary[k].first;
+      left_inside[k] = (c0 > 0) && coarse_inside(row.inside, c0 - 1);
+    }
+
+    for (unsigned int r = top; r < bottom; r++) {
+      std::vector<Crossing> &line = crossings[r - top];
+      std::sort(line.begin(), line.end(), less_by_crossing_x());
+      std::vector<Crossing>::iterator cross = line.begin();
+      //clean parts and boundary runs don't overlap and coarse columns rise
+      //with x, so all three are walked together in column order
+      filled.clear();
+      size_t c = 0;
+      for (size_t k = 0; k < row.boundary.size(); k++) {
+        long c0 = row.boundary[k].first, c1 = row.boundary[k].second;
+        for (; c < clean.size() && clean[c].first < c0 * factor; c++) {
+          push_run(filled, clean[c].first, clean[c].second);
+        }
+        local.clear();
+        for (; cross != line.end() && (*cross).coarse_col <= c1; ++cross) {
+          if ((*cross).coarse_col >= c0) local.push_back((*cross).col);
+        }
+        //walk the run, flipping at each crossing
+        long cur = c0 * factor, last = (c1 + 1) * factor - 1;
+        bool state = left_inside[k];
+        for (size_t j = 0; j < local.size(); j++) {
+          long at = std::min((long)local[j], last + 1);
+          if (state && at > cur) push_run(filled, cur, at - 1);
+          cur = std::max(cur, at);
+          state = !state;
+        }
+        if (state && cur <= last) push_run(filled, cur, last);
+      }
+      for (; c < clean.size(); c++) push_run(filled, clean[c].first, clean[c].second);
+      for (size_t i = 0; i < filled.size(); i++) {
+        spans.push_back(Span(filled[i].first, filled[i].second, r, poly_id));
+      }
+    }
+  }
+}
+
+// Refine a polygon burn to a grid factor times finer
+//
+// @param sf an [sf::sf()] object with a geometry column of POLYGON and/or
+// MULTIPOLYGON objects, the same features the index was burned from
+// @param index list of records (xstart, xend, row, poly_id) from burn_polygon()
+// @param extent numeric vector c(xmin, xmax, ymin , ymax)
+// @param dimension integer vector c(ncol, nrow) of the coarse grid
+// @param factor integer refinement, the fine grid is dimension * factor
+// @return list of records (xstart, xend, row, poly_id) on the fine grid,
+// covering the same cells as burn_polygon() at the fine resolution (touching
+// spans are merged)
+// [[Rcpp::export]]
+Rcpp::List burn_polygon_refine(Rcpp::DataFrame &sf,
+                               Rcpp::List &index,
+                               Rcpp::NumericVector &extent,
+                               Rcpp::IntegerVector &dimension,
+                               int factor) {
+  Rcpp::List polygons;
+  check_inputs_polygon(sf, polygons);  // Also fills in polygons
+  if (factor < 1) Rcpp::stop("factor must be a positive integer");
+
+  RasterInfo ras(extent, dimension);
+  Rcpp::IntegerVector fine_dimension = Rcpp::IntegerVector::create(ras.ncol * factor, ras.nrow * factor);
+  RasterInfo fine(extent, fine_dimension);
+
+  std::vector<Feature> features;
+  features_from_list(polygons, features);
+  std::vector<const int *> records;
+  index_records(index, 4, records);
+  std::vector< std::vector<const int *> > coarse(features.size());
+  for (size_t i = 0; i < records.size(); i++) {
+    const int *rec = records[i];
+    if (rec[3] < 0 || rec[3] >= (int)features.size() ||
+        rec[0] < 0 || rec[1] >= (int)ras.ncol || rec[2] < 0 || rec[2] >= (int)ras.nrow) {
+      Rcpp::stop("index does not belong to these features and dimension");
+    }
+    coarse[rec[3]].push_back(rec);
+  }
+
+  std::vector< std::vector<Span> > parts(features.size());
+  double cost = 0;
+  for (size_t i = 0; i < features.size(); i++) cost += feature_cost(features[i], fine);
+  task_pool().parallel_for(features.size(), cost, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      refine_feature(features[i], coarse[i], ras, fine, factor, parts[i], i);
+    }
+  });
+  std::vector<Span> spans;
+  for (size_t i = 0; i < parts.size(); i++) {
+    spans.insert(spans.end(), parts[i].begin(), parts[i].end());
+  }
+  return spans_to_list(spans);
+}
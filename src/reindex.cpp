@@ -0,0 +1,66 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "edge.h"
+#include "CollectorList.h"
+
+// Integer offset of grid "to" within grid "from", in columns right and rows
+// down, when both have the same resolution and cell edges line up
+bool grid_offset(RasterInfo &from, RasterInfo &to, long &dx, long &dy) {
+  double tol = 1e-6;
+  if (std::fabs(from.xres - to.xres) > tol * from.xres ||
+      std::fabs(from.yres - to.yres) > tol * from.yres) {
+    return false;
+  }
+  double ox = (to.xmin - from.xmin)/from.xres;
+  double oy = (from.ymax - to.ymax)/from.yres;
+  dx = std::floor(ox + 0.5);
+  dy = std::floor(oy + 0.5);
+  return std::fabs(ox - dx) <= tol && std::fabs(oy - dy) <= tol;
+}
+
+// Move an index to an aligned grid, cropping, padding or shifting
+//
+// Span coordinates are offset by the whole number of cells between the two
+// grids and clipped to the new one in a single pass, with no re-burn. Any
+// fields after (xstart, xend, row) are carried through, so layered indexes
+// work too.
+//
+// @param index list of records starting (xstart, xend, row)
+// @param extent,dimension grid the index was burned on
+// @param new_extent,new_dimension grid to move to, same resolution and aligned
+// @return list of records on the new grid, spans wholly outside are dropped
+// [[Rcpp::export]]
+Rcpp::List span_reindex(Rcpp::List &index,
+                        Rcpp::NumericVector &extent,
+                        Rcpp::IntegerVector &dimension,
+                        Rcpp::NumericVector &new_extent,
+                        Rcpp::IntegerVector &new_dimension) {
+  RasterInfo from(extent, dimension), to(new_extent, new_dimension);
+  long dx, dy;
+  if (!grid_offset(from, to, dx, dy)) {
+    Rcpp::stop("grids must have the same resolution and aligned cell edges");
+  }
+
+  CollectorList out_vector(index.size() + 1);
+  for (R_xlen_t i = 0; i < index.size(); i++) {
+    SEXP rec = index[i];
+    R_xlen_t n = Rf_xlength(rec);
+    if (TYPEOF(rec) != INTSXP || n < 3) {
+      Rcpp::stop("index records must be integer vectors starting (xstart, xend, row)");
+    }
+    const int *r = INTEGER(rec);
+    long row = r[2] - dy;
+    if (row < 0 || row >= (long)to.nrow) continue;
+    long xs = std::max(r[0] - dx, 0L);
+    long xe = std::min(r[1] - dx, (long)to.ncol - 1);
+    if (xs > xe) continue;
+
+    Rcpp::IntegerVector moved(n);
+    std::copy(r, r + n, moved.begin());
+    moved[0] = xs;
+    moved[1] = xe;
+    moved[2] = row;
+    out_vector.push_back(moved);
+  }
+  return out_vector.vector();
+}
@@ -0,0 +1,267 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "simd.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SIMD_X86
+#include <immintrin.h>
+#endif
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+static const double pos_inf = std::numeric_limits<double>::infinity();
+
+// Plain loops, the remainder of every variant too
+
+static void span_fill_generic(int *cell, size_t n) {
+  for (size_t i = 0; i < n; i++) cell[i]++;
+}
+
+static void span_stats_generic(const double *value, size_t n,
+                               double *count, double *sum, double *min, double *max) {
+  double c = 0, s = 0, lo = pos_inf, hi = -pos_inf;
+  for (size_t i = 0; i < n; i++) {
+    double v = value[i];
+    if (v != v) continue;
+    c++;
+    s += v;
+    lo = std::min(lo, v);
+    hi = std::max(hi, v);
+  }
+  *count += c;
+  *sum += s;
+  *min = std::min(*min, lo);
+  *max = std::max(*max, hi);
+}
+
+static size_t equal_run_from(const double *value, size_t i, size_t n) {
+  while (i < n && value[i] == value[0]) i++;
+  return i;
+}
+
+static size_t equal_run_generic(const double *value, size_t n) {
+  return n == 0 ? 0 : equal_run_from(value, 1, n);
+}
+
+#ifdef SIMD_X86
+
+__attribute__((target("avx2")))
+static void span_fill_avx2(int *cell, size_t n) {
+  const __m256i one = _mm256_set1_epi32(1);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i c = _mm256_loadu_si256((const __m256i *)(cell + i));
+    _mm256_storeu_si256((__m256i *)(cell + i), _mm256_add_epi32(c, one));
+  }
+  span_fill_generic(cell + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static void span_stats_avx2(const double *value, size_t n,
+                            double *count, double *sum, double *min, double *max) {
+  const __m256d one = _mm256_set1_pd(1.0);
+  __m256d c = _mm256_setzero_pd(), s = _mm256_setzero_pd();
+  __m256d lo = _mm256_set1_pd(pos_inf), hi = _mm256_set1_pd(-pos_inf);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d v = _mm256_loadu_pd(value + i);
+    __m256d ok = _mm256_cmp_pd(v, v, _CMP_ORD_Q);  //not NaN
+    c = _mm256_add_pd(c, _mm256_and_pd(one, ok));
+    s = _mm256_add_pd(s, _mm256_and_pd(v, ok));
+    lo = _mm256_min_pd(lo, _mm256_blendv_pd(lo, v, ok));
+    hi = _mm256_max_pd(hi, _mm256_blendv_pd(hi, v, ok));
+  }
+  double lane_c[4], lane_s[4], lane_lo[4], lane_hi[4];
+  _mm256_storeu_pd(lane_c, c);
+  _mm256_storeu_pd(lane_s, s);
+  _mm256_storeu_pd(lane_lo, lo);
+  _mm256_storeu_pd(lane_hi, hi);
+  for (int k = 0; k < 4; k++) {
+    *count += lane_c[k];
+    *sum += lane_s[k];
+    *min = std::min(*min, lane_lo[k]);
+    *max = std::max(*max, lane_hi[k]);
+  }
+  span_stats_generic(value + i, n - i, count, sum, min, max);
+}
+
+__attribute__((target("avx2")))
+static size_t equal_run_avx2(const double *value, size_t n) {
+  if (n == 0) return 0;
+  const __m256d first = _mm256_set1_pd(value[0]);
+  size_t i = 1;
+  for (; i + 4 <= n; i += 4) {
+    int same = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(value + i), first, _CMP_EQ_OQ));
+    if (same != 0xF) return i + __builtin_ctz(~same);
+  }
+  return equal_run_from(value, i, n);
+}
+
+__attribute__((target("avx512f")))
+static void span_fill_avx512(int *cell, size_t n) {
+  const __m512i one = _mm512_set1_epi32(1);
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m512i c = _mm512_loadu_si512((const void *)(cell + i));
+    _mm512_storeu_si512((void *)(cell + i), _mm512_add_epi32(c, one));
+  }
+  span_fill_generic(cell + i, n - i);
+}
+
+__attribute__((target("avx512f")))
+static void span_stats_avx512(const double *value, size_t n,
+                              double *count, double *sum, double *min, double *max) {
+  const __m512d one = _mm512_set1_pd(1.0);
+  __m512d c = _mm512_setzero_pd(), s = _mm512_setzero_pd();
+  __m512d lo = _mm512_set1_pd(pos_inf), hi = _mm512_set1_pd(-pos_inf);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512d v = _mm512_loadu_pd(value + i);
+    __mmask8 ok = _mm512_cmp_pd_mask(v, v, _CMP_ORD_Q);  //not NaN
+    c = _mm512_mask_add_pd(c, ok, c, one);
+    s = _mm512_mask_add_pd(s, ok, s, v);
+    lo = _mm512_mask_min_pd(lo, ok, lo, v);
+    hi = _mm512_mask_max_pd(hi, ok, hi, v);
+  }
+  double lane_c[8], lane_s[8], lane_lo[8], lane_hi[8];
+  _mm512_storeu_pd(lane_c, c);
+  _mm512_storeu_pd(lane_s, s);
+  _mm512_storeu_pd(lane_lo, lo);
+  _mm512_storeu_pd(lane_hi, hi);
+  for (int k = 0; k < 8; k++) {
+    *count += lane_c[k];
+    *sum += lane_s[k];
+    *min = std::min(*min, lane_lo[k]);
+    *max = std::max(*max, lane_hi[k]);
+  }
+  span_stats_generic(value + i, n - i, count, sum, min, max);
+}
+
+__attribute__((target("avx512f")))
+static size_t equal_run_avx512(const double *value, size_t n) {
+  if (n == 0) return 0;
+  const __m512d first = _mm512_set1_pd(value[0]);
+  size_t i = 1;
+  for (; i + 8 <= n; i += 8) {
+    unsigned int same = _mm512_cmp_pd_mask(_mm512_loadu_pd(value + i), first, _CMP_EQ_OQ);
+    if (same != 0xFF) return i + __builtin_ctz(~same);
+  }
+  return equal_run_from(value, i, n);
+}
+
+#endif
+
+#ifdef SIMD_NEON
+
+static void span_fill_neon(int *cell, size_t n) {
+  const int32x4_t one = vdupq_n_s32(1);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    vst1q_s32(cell + i, vaddq_s32(vld1q_s32(cell + i), one));
+  }
+  span_fill_generic(cell + i, n - i);
+}
+
+static void span_stats_neon(const double *value, size_t n,
+                            double *count, double *sum, double *min, double *max) {
+  const float64x2_t zero = vdupq_n_f64(0.0), one = vdupq_n_f64(1.0);
+  float64x2_t c = zero, s = zero;
+  float64x2_t lo = vdupq_n_f64(pos_inf), hi = vdupq_n_f64(-pos_inf);
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    float64x2_t v = vld1q_f64(value + i);
+    uint64x2_t ok = vceqq_f64(v, v);  //not NaN
+    c = vaddq_f64(c, vbslq_f64(ok, one, zero));
+    s = vaddq_f64(s, vbslq_f64(ok, v, zero));
+    lo = vminq_f64(lo, vbslq_f64(ok, v, lo));
+    hi = vmaxq_f64(hi, vbslq_f64(ok, v, hi));
+  }
+  for (int k = 0; k < 2; k++) {
+    double lane_lo = k ? vgetq_lane_f64(lo, 1) : vgetq_lane_f64(lo, 0);
+    double lane_hi = k ? vgetq_lane_f64(hi, 1) : vgetq_lane_f64(hi, 0);
+    *count += k ? vgetq_lane_f64(c, 1) : vgetq_lane_f64(c, 0);
+    *sum += k ? vgetq_lane_f64(s, 1) : vgetq_lane_f64(s, 0);
+    *min = std::min(*min, lane_lo);
+    *max = std::max(*max, lane_hi);
+  }
+  span_stats_generic(value + i, n - i, count, sum, min, max);
+}
+
+static size_t equal_run_neon(const double *value, size_t n) {
+  if (n == 0) return 0;
+  const float64x2_t first = vdupq_n_f64(value[0]);
+  size_t i = 1;
+  for (; i + 2 <= n; i += 2) {
+    uint64x2_t same = vceqq_f64(vld1q_f64(value + i), first);
+    if (vgetq_lane_u64(same, 0) == 0) return i;
+    if (vgetq_lane_u64(same, 1) == 0) return i + 1;
+  }
+  return equal_run_from(value, i, n);
+}
+
+#endif
+
+static const SimdKernels simd_variants[] = {
+  {"generic", span_fill_generic, span_stats_generic, equal_run_generic},
+#ifdef SIMD_X86
+  {"avx2", span_fill_avx2, span_stats_avx2, equal_run_avx2},
+  {"avx512", span_fill_avx512, span_stats_avx512, equal_run_avx512},
+#endif
+#ifdef SIMD_NEON
+  {"neon", span_fill_neon, span_stats_neon, equal_run_neon},
+#endif
+};
+
+std::vector<std::string> simd_available() {
+  std::vector<std::string> names;
+  names.push_back("generic");
+#ifdef SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) names.push_back("avx2");
+  if (__builtin_cpu_supports("avx512f")) names.push_back("avx512");
+#endif
+#ifdef SIMD_NEON
+  names.push_back("neon");
+#endif
+  return names;
+}
+
+const SimdKernels &simd_kernels() {
+  static const std::vector<std::string> available = simd_available();
+  std::string name;
+  SEXP option = Rf_GetOption1(Rf_install("controlledburn.simd"));
+  const char *env = std::getenv("CONTROLLEDBURN_SIMD");
+  if (!Rf_isNull(option)) {
+    name = Rcpp::as<std::string>(option);
+  } else if (env != NULL) {
+    name = env;
+  }
+  if (name.empty() || name == "auto") name = available.back();
+  if (std::find(available.begin(), available.end(), name) == available.end()) {
+    Rcpp::stop("SIMD variant \"%s\" is not available on this CPU", name);
+  }
+  for (size_t i = 0; i < sizeof(simd_variants) / sizeof(simd_variants[0]); i++) {
+    if (name == simd_variants[i].name) return simd_variants[i];
+  }
+  return simd_variants[0];
+}
+
+// SIMD variants of the native kernels
+//
+// Set option "controlledburn.simd" to one of the available names to force it,
+// for benchmarking or testing.
+//
+// @return list with available, the variants this CPU can run (best last), and
+// active, the one used under the current options
+// [[Rcpp::export]]
+Rcpp::List simd_info() {
+  std::vector<std::string> available = simd_available();
+  return Rcpp::List::create(Rcpp::Named("available") = Rcpp::wrap(available),
+                            Rcpp::Named("active") = std::string(simd_kernels().name));
+}
@@ -0,0 +1,34 @@
+#ifndef SIMD_KERNELS
+#define SIMD_KERNELS
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Hot loops in variants by instruction set, chosen at run time
+//
+// The package is built for the baseline of its platform, so wider vector
+// units are reached through functions compiled for them alone and picked
+// once the CPU is known: AVX2 and AVX-512 on x86 with GCC or clang, NEON
+// (baseline on arm64) there, and plain loops everywhere.
+struct SimdKernels {
+  const char *name;
+  // Add one to each of n counts, a span fill
+  void (*span_fill)(int *cell, size_t n);
+  // Count, sum, min and max of the non-missing of n values, a zonal
+  // accumulation; the results are added into the outputs
+  void (*span_stats)(const double *value, size_t n,
+                     double *count, double *sum, double *min, double *max);
+  // Length of the run of values equal to the first, for run length encoding
+  size_t (*equal_run)(const double *value, size_t n);
+};
+
+// Names of the variants this CPU can run, best last
+extern std::vector<std::string> simd_available();
+
+// Kernels by option "controlledburn.simd" or else the environment variable
+// CONTROLLEDBURN_SIMD naming a variant, or the best available if unset or
+// "auto"; call on the R thread and hand the result to tasks
+extern const SimdKernels &simd_kernels();
+
+#endif
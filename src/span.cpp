@@ -0,0 +1,27 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "span.h"
+#include "CollectorList.h"
+
+// Spans as the list of records (xstart, xend, row, poly_id) returned to R
+Rcpp::List spans_to_list(const std::vector<Span> &spans) {
+  CollectorList out_vector(spans.size() + 1);
+  for (std::vector<Span>::const_iterator sp = spans.begin(); sp != spans.end(); ++sp) {
+    out_vector.push_back(Rcpp::IntegerVector::create((*sp).xstart, (*sp).xend,
+                                                     (*sp).row, (*sp).poly_id));
+  }
+  return out_vector.vector();
+}
+
+// Pointers to the values of each integer record of an index, so it can be
+// read away from the R thread. The index must outlive the pointers.
+void index_records(Rcpp::List &index, int nfield, std::vector<const int *> &records) {
+  records.resize(index.size());
+  for (R_xlen_t i = 0; i < index.size(); i++) {
+    SEXP rec = index[i];
+    if (TYPEOF(rec) != INTSXP || Rf_xlength(rec) < nfield) {
+      Rcpp::stop("index records must be integer vectors of length %i", nfield);
+    }
+    records[i] = INTEGER(rec);
+  }
+}
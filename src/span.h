@@ -0,0 +1,27 @@
+#ifndef SPAN
+#define SPAN
+
+#include "Rcpp.h"
+using namespace Rcpp;
+
+// A single scanline run of a burned feature, in the same terms as the
+// records returned to R: zero-based, and xend is the last column covered
+struct Span {
+  unsigned int xstart, xend, row, poly_id;
+
+  Span() : xstart(0), xend(0), row(0), poly_id(0) {}
+  Span(unsigned int xs, unsigned int xe, unsigned int y, unsigned int id) :
+    xstart(xs), xend(xe), row(y), poly_id(id) {}
+};
+
+struct less_by_row_xstart {
+  inline bool operator() (const Span& span1, const Span& span2) {
+    return ((span1.row < span2.row) ||
+            ((span1.row == span2.row) && (span1.xstart < span2.xstart)));
+  }
+};
+
+extern Rcpp::List spans_to_list(const std::vector<Span> &spans);
+extern void index_records(Rcpp::List &index, int nfield, std::vector<const int *> &records);
+
+#endif
@@ -0,0 +1,104 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "spanfile.h"
+#include "rasterize.h"
+
+#include <sys/stat.h>
+
+void write_spanfile_header(unsigned char *header, unsigned int ncol, unsigned int nrow,
+                           uint64_t count) {
+  int32_t dims[2] = {(int32_t)ncol, (int32_t)nrow};
+  std::memcpy(header, SPANFILE_MAGIC, 8);
+  std::memcpy(header + 8, dims, 8);
+  std::memcpy(header + 16, &count, 8);
+}
+
+bool read_spanfile_header(FILE *file, unsigned int &ncol, unsigned int &nrow,
+                          uint64_t &count) {
+  unsigned char header[SPANFILE_HEADER];
+  int32_t dims[2];
+  if (std::fread(header, 1, SPANFILE_HEADER, file) != SPANFILE_HEADER) return false;
+  if (std::memcmp(header, SPANFILE_MAGIC, 8) != 0) return false;
+  std::memcpy(dims, header + 8, 8);
+  std::memcpy(&count, header + 16, 8);
+  ncol = dims[0];
+  nrow = dims[1];
+  return true;
+}
+
+bool SpanFileWriter::open(const std::string &path, unsigned int ncol, unsigned int nrow) {
+  unsigned char header[SPANFILE_HEADER];
+  file_ = std::fopen(path.c_str(), "wb");
+  if (file_ == NULL) return false;
+  count_ = 0;
+  failed_ = false;
+  write_spanfile_header(header, ncol, nrow, 0);
+  return std::fwrite(header, 1, SPANFILE_HEADER, file_) == SPANFILE_HEADER;
+}
+
+// A failed write is remembered and reported by close()
+void SpanFileWriter::write(const Span *spans, size_t n) {
+  int32_t rec[4];
+  for (size_t i = 0; i < n && !failed_; i++) {
+    rec[0] = spans[i].xstart;
+    rec[1] = spans[i].xend;
+    rec[2] = spans[i].row;
+    rec[3] = spans[i].poly_id;
+    failed_ = std::fwrite(rec, sizeof(int32_t), 4, file_) != 4;
+  }
+  count_ += n;
+}
+
+// Finish the file, filling in the record count
+bool SpanFileWriter::close() {
+  if (file_ == NULL) return true;
+  bool ok = !failed_ && std::fseek(file_, 16, SEEK_SET) == 0 &&
+    std::fwrite(&count_, sizeof(uint64_t), 1, file_) == 1;
+  ok = (std::fclose(file_) == 0) && ok;
+  file_ = NULL;
+  return ok;
+}
+
+// Read the records of a span file, checking the count in its header against
+// the size of the file before anything is allocated for them
+void read_spanfile_records(const std::string &path, std::vector<Span> &spans,
+                           unsigned int &ncol, unsigned int &nrow) {
+  uint64_t count;
+  int32_t rec[4];
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0) Rcpp::stop("cannot open span file");
+  FILE *file = std::fopen(path.c_str(), "rb");
+  if (file == NULL) Rcpp::stop("cannot open span file");
+  if (!read_spanfile_header(file, ncol, nrow, count)) {
+    std::fclose(file);
+    Rcpp::stop("not a span file");
+  }
+  if (count > (uint64_t)(st.st_size - SPANFILE_HEADER) / SPANFILE_RECORD) {
+    std::fclose(file);
+    Rcpp::stop("span file is truncated");
+  }
+  spans.reserve(spans.size() + count);
+  for (uint64_t i = 0; i < count; i++) {
+    if (std::fread(rec, sizeof(int32_t), 4, file) != 4) {
+      std::fclose(file);
+      Rcpp::stop("span file is truncated");
+    }
+    spans.push_back(Span(rec[0], rec[1], rec[2], rec[3]));
+  }
+  std::fclose(file);
+}
+
+// Read a binary span file
+//
+// @param path file written by burn_wkb_pipeline() or the other span file writers
+// @return list of records (xstart, xend, row, poly_id) as from burn_polygon(),
+// with attribute "dimension" c(ncol, nrow)
+// [[Rcpp::export]]
+Rcpp::List read_spanfile(std::string path) {
+  unsigned int ncol, nrow;
+  std::vector<Span> spans;
+  read_spanfile_records(path, spans, ncol, nrow);
+  Rcpp::List out = spans_to_list(spans);
+  out.attr("dimension") = Rcpp::IntegerVector::create(ncol, nrow);
+  return out;
+}
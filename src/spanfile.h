@@ -0,0 +1,42 @@
+#ifndef SPANFILE
+#define SPANFILE
+
+#include "span.h"
+#include <cstdio>
+#include <stdint.h>
+
+// Binary span file
+//
+// A 24 byte header, the magic "CBSPAN01", int32 ncol and nrow and the uint64
+// number of records, followed by the records as int32 (xstart, xend, row,
+// poly_id). Values are in native byte order, the file is a scratch and
+// exchange format on one machine rather than an archive format.
+#define SPANFILE_MAGIC "CBSPAN01"
+#define SPANFILE_HEADER 24
+#define SPANFILE_RECORD 16
+
+class SpanFileWriter {
+public:
+  SpanFileWriter() : file_(NULL), count_(0), failed_(false) {}
+  ~SpanFileWriter() { close(); }
+
+  bool open(const std::string &path, unsigned int ncol, unsigned int nrow);
+  void write(const Span *spans, size_t n);
+  // false if the file could not be finished or any write failed
+  bool close();
+  uint64_t count() const { return count_; }
+
+private:
+  FILE *file_;
+  uint64_t count_;
+  bool failed_;
+};
+
+extern void write_spanfile_header(unsigned char *header, unsigned int ncol, unsigned int nrow,
+                                  uint64_t count);
+extern bool read_spanfile_header(FILE *file, unsigned int &ncol, unsigned int &nrow,
+                                 uint64_t &count);
+extern void read_spanfile_records(const std::string &path, std::vector<Span> &spans,
+                                  unsigned int &ncol, unsigned int &nrow);
+
+#endif
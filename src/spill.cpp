@@ -0,0 +1,148 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "edge.h"
+#include "check_inputs.h"
+
+#include "rasterize.h"
+#include "spill.h"
+
+#include <queue>
+
+SpanSpiller::SpanSpiller(const std::string &path, unsigned int ncol, unsigned int nrow,
+                         size_t budget_bytes) :
+  path_(path), ncol_(ncol), nrow_(nrow) {
+  capacity_ = std::max(budget_bytes / sizeof(Span), (size_t)1024);
+  buffer_.reserve(capacity_);
+}
+
+SpanSpiller::~SpanSpiller() {
+  for (size_t k = 0; k < runs_.size(); k++) std::remove(runs_[k].c_str());
+}
+
+void SpanSpiller::add(const std::vector<Span> &spans) {
+  for (size_t i = 0; i < spans.size(); i++) {
+    if (buffer_.size() == capacity_) spill();
+    buffer_.push_back(spans[i]);
+  }
+}
+
+// Sort the buffer and write it out as the next run
+void SpanSpiller::spill() {
+  std::stable_sort(buffer_.begin(), buffer_.end(), less_by_row_xstart());
+  std::stringstream run;
+  run << path_ << ".run" << runs_.size();
+  runs_.push_back(run.str());
+  FILE *file = std::fopen(runs_.back().c_str(), "wb");
+  if (file == NULL) Rcpp::stop("cannot open temporary run file");
+  size_t n = std::fwrite(buffer_.data(), sizeof(Span), buffer_.size(), file);
+  bool ok = (std::fclose(file) == 0) && (n == buffer_.size());
+  if (!ok) Rcpp::stop("failed writing temporary run file");
+  buffer_.clear();
+}
+
+// A run being merged, read a block at a time
+struct SpillRun {
+  FILE *file;
+  std::vector<Span> block;
+  size_t pos;
+
+  bool refill() {
+    block.resize(block.capacity());
+    size_t n = std::fread(block.data(), sizeof(Span), block.size(), file);
+    block.resize(n);
+    pos = 0;
+    return n > 0;
+  }
+};
+
+// Heap order, smallest (row, xstart) on top and earlier runs first on ties
+struct greater_run_head {
+  std::vector<SpillRun> *runs;
+  inline bool operator() (size_t a, size_t b) {
+    const Span &sa = (*runs)[a].block[(*runs)[a].pos], &sb = (*runs)[b].block[(*runs)[b].pos];
+    if (sa.row != sb.row) return sa.row > sb.row;
+    if (sa.xstart != sb.xstart) return sa.xstart > sb.xstart;
+    return a > b;
+  }
+};
+
+void SpanSpiller::merge() {
+  size_t block_size = std::max(capacity_ / (runs_.size() + 1), (size_t)1024);
+  std::vector<SpillRun> runs(runs_.size());
+  greater_run_head order = {&runs};
+  std::priority_queue<size_t, std::vector<size_t>, greater_run_head> heads(order);
+
+  SpanFileWriter out;
+  if (!out.open(path_, ncol_, nrow_)) Rcpp::stop("cannot open span file for writing");
+  for (size_t k = 0; k < runs.size(); k++) {
+    runs[k].file = std::fopen(runs_[k].c_str(), "rb");
+    if (runs[k].file == NULL) Rcpp::stop("cannot open temporary run file");
+    runs[k].block.reserve(block_size);
+    if (runs[k].refill()) heads.push(k);
+  }
+  //output goes through the (now empty) sort buffer
+  buffer_.clear();
+  while (!heads.empty()) {
+    size_t k = heads.top();
+    heads.pop();
+    buffer_.push_back(runs[k].block[runs[k].pos++]);
+    if (buffer_.size() == block_size) {
+      out.write(buffer_.data(), buffer_.size());
+      buffer_.clear();
+    }
+    if (runs[k].pos < runs[k].block.size() || runs[k].refill()) heads.push(k);
+  }
+  out.write(buffer_.data(), buffer_.size());
+  buffer_.clear();
+  for (size_t k = 0; k < runs.size(); k++) std::fclose(runs[k].file);
+  if (!out.close()) Rcpp::stop("failed writing span file");
+}
+
+void SpanSpiller::finish() {
+  if (runs_.empty()) {
+    //everything fit in memory, no runs needed
+    std::stable_sort(buffer_.begin(), buffer_.end(), less_by_row_xstart());
+    SpanFileWriter out;
+    if (!out.open(path_, ncol_, nrow_)) Rcpp::stop("cannot open span file for writing");
+    out.write(buffer_.data(), buffer_.size());
+    if (!out.close()) Rcpp::stop("failed writing span file");
+    buffer_.clear();
+    return;
+  }
+  if (!buffer_.empty()) spill();
+  merge();
+}
+
+// Rasterize polygons into a row-major span file, sorting outside memory
+//
+// @param sf an [sf::sf()] object with a geometry column of POLYGON and/or
+// MULTIPOLYGON objects.
+// @param extent numeric vector c(xmin, xmax, ymin , ymax)
+// @param dimension integer vector c(ncol, nrow)
+// @param path span file to write (see read_spanfile()), sorted runs are
+// written next to it while the burn is in progress
+// @param memory_mb memory budget for buffered spans, in megabytes
+// @return path, spans are ordered by row then xstart
+// [[Rcpp::export]]
+std::string burn_polygon_sorted(Rcpp::DataFrame &sf,
+                                Rcpp::NumericVector &extent,
+                                Rcpp::IntegerVector &dimension,
+                                std::string path,
+                                double memory_mb = 256) {
+  Rcpp::List polygons;
+  check_inputs_polygon(sf, polygons);  // Also fills in polygons
+
+  if (!(memory_mb > 0) || !R_FINITE(memory_mb)) Rcpp::stop("memory_mb must be a positive number");
+
+  RasterInfo ras(extent, dimension);
+  SpanSpiller spiller(path, ras.ncol, ras.nrow, memory_mb * 1024 * 1024);
+  std::vector<Span> spans;
+  Rcpp::List::iterator p = polygons.begin();
+  for(; p != polygons.end(); ++p) {
+    spans.clear();
+    rasterize_polygon( (*p), ras, spans, p.index());
+    spiller.add(spans);
+  }
+  spiller.finish();
+  return path;
+}
@@ -0,0 +1,33 @@
+#ifndef SPILL
+#define SPILL
+
+#include "span.h"
+#include "spanfile.h"
+
+// External-memory sort of spans into a row-major span file
+//
+// Spans are buffered up to a memory budget, each full buffer is sorted by
+// (row, xstart) and written to a temporary run file, and finish() merges the
+// runs k ways into the final span file. Runs and output are only ever read
+// and written front to back in large blocks. Equal keys keep the order they
+// were added in.
+class SpanSpiller {
+public:
+  SpanSpiller(const std::string &path, unsigned int ncol, unsigned int nrow, size_t budget_bytes);
+  ~SpanSpiller();
+
+  void add(const std::vector<Span> &spans);
+  void finish();
+
+private:
+  std::string path_;
+  unsigned int ncol_, nrow_;
+  size_t capacity_;  // spans held in memory
+  std::vector<Span> buffer_;
+  std::vector<std::string> runs_;
+
+  void spill();
+  void merge();
+};
+
+#endif
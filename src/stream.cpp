@@ -0,0 +1,145 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "edge.h"
+#include "check_inputs.h"
+
+#include "geometry.h"
+#include "rasterize.h"
+#include "traverse.h"
+
+#include <unordered_map>
+
+// Stream burning
+//
+// Each part of a line is walked cell by cell from its first vertex
+// (upstream) to its last, and the elevations along the path are optionally
+// smoothed by a moving average, lowered by drop and, with monotone, held to
+// never rise downstream. A cell is only ever lowered. Lines are applied in
+// feature order, so a later stream sees the burns of earlier ones, but lines
+// that share no cell do not depend on each other: each line goes in the wave
+// after the last wave that touched any of its cells, and the lines of one
+// wave run in parallel.
+
+// Cells of each part of a line in path order, repeats in a row dropped
+void stream_paths(const Feature &feature, RasterInfo &ras, std::vector< std::vector<size_t> > &paths) {
+  for(Feature::const_iterator part = feature.begin(); part != feature.end(); ++part) {
+    const std::vector<double> &x = (*part).x, &y = (*part).y;
+    std::vector<size_t> path;
+    for(size_t i = 0; i + 1 < x.size(); ++i) {
+      traverse_segment(x[i], y[i], x[i + 1], y[i + 1], ras,
+                       [&](unsigned int col, unsigned int row, double) {
+        size_t cell = (size_t)row * ras.ncol + col;
+        if (path.empty() || path.back() != cell) path.push_back(cell);
+      });
+    }
+    if (!path.empty()) paths.push_back(path);
+  }
+}
+
+void burn_stream_path(const std::vector<size_t> &path, double *dem, double drop, int window, bool monotone) {
+  //read the whole path first, so a cell passed twice is lowered once
+  std::vector<double> z(path.size());
+  for (size_t i = 0; i < path.size(); i++) z[i] = dem[path[i]];
+  std::vector<double> original(z);
+  if (window > 1) {
+    std::vector<double> smooth(z.size());
+    long half = window / 2;
+    for (long i = 0; i < (long)z.size(); i++) {
+      double sum = 0;
+      int n = 0;
+      for (long k = std::max(i - half, 0L); k <= std::min(i + half, (long)z.size() - 1); k++) {
+        if (!ISNAN(z[k])) {
+          sum += z[k];
+          n++;
+        }
+      }
+      smooth[i] = (ISNAN(z[i]) || n == 0) ? z[i] : sum / n;
+    }
+    z.swap(smooth);
+  }
+  double running = R_PosInf;
+  for (size_t i = 0; i < path.size(); i++) {
+    if (ISNAN(z[i])) continue;
+    double burned = std::min(z[i] - drop, original[i]);
+    if (monotone) {
+      running = std::min(running, burned);
+      burned = running;
+    }
+    dem[path[i]] = std::min(dem[path[i]], burned);
+  }
+}
+
+// Burn stream lines into a DEM, in place
+//
+// @param sf an [sf::sf()] object with a geometry column of LINESTRING and/or
+// MULTILINESTRING objects, each drawn from upstream to downstream
+// @param extent numeric vector c(xmin, xmax, ymin , ymax)
+// @param dimension integer vector c(ncol, nrow)
+// @param dem numeric matrix of elevations with dim c(ncol, nrow), row by row
+// from the top left as materialized; it is modified in place
+// @param drop depth to lower each stream cell by
+// @param window cells in the moving average along the stream, 1 for none
+// @param monotone never let elevation rise going downstream
+// @return dem, burned
+// [[Rcpp::export]]
+Rcpp::NumericVector burn_stream(Rcpp::DataFrame &sf,
+                                Rcpp::NumericVector &extent,
+                                Rcpp::IntegerVector &dimension,
+                                Rcpp::NumericVector &dem,
+                                double drop = 0,
+                                int window = 1,
+                                bool monotone = true) {
+  Rcpp::List lines;
+  check_inputs_line(sf, lines);  // Also fills in lines
+  RasterInfo ras(extent, dimension);
+  if ((size_t)dem.size() != (size_t)ras.ncol * ras.nrow) Rcpp::stop("dem must have ncol * nrow elements");
+  if (window < 1) Rcpp::stop("window must be at least 1");
+
+  std::vector<Feature> features;
+  features_from_list(lines, features);
+  std::vector< std::vector< std::vector<size_t> > > paths(features.size());
+  double cost = 0;
+  for (size_t i = 0; i < features.size(); i++) cost += feature_cost(features[i], ras);
+  task_pool().parallel_for(features.size(), cost, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      stream_paths(features[i], ras, paths[i]);
+    }
+  });
+
+  //wave of each line, one after the last wave to touch any of its cells
+  std::unordered_map<size_t, int> last_wave;
+  std::vector< std::vector<size_t> > waves;
+  for (size_t i = 0; i < paths.size(); i++) {
+    int wave = 0;
+    for (size_t p = 0; p < paths[i].size(); p++) {
+      for (size_t k = 0; k < paths[i][p].size(); k++) {
+        std::unordered_map<size_t, int>::iterator it = last_wave.find(paths[i][p][k]);
+        if (it != last_wave.end()) wave = std::max(wave, it->second + 1);
+      }
+    }
+    for (size_t p = 0; p < paths[i].size(); p++) {
+      for (size_t k = 0; k < paths[i][p].size(); k++) {
+        last_wave[paths[i][p][k]] = wave;
+      }
+    }
+    if ((size_t)wave >= waves.size()) waves.resize(wave + 1);
+    waves[wave].push_back(i);
+  }
+
+  double *z = dem.begin();
+  for (size_t w = 0; w < waves.size(); w++) {
+    std::vector<size_t> &wave = waves[w];
+    double wave_cost = 0;
+    for (size_t j = 0; j < wave.size(); j++) {
+      for (size_t p = 0; p < paths[wave[j]].size(); p++) wave_cost += paths[wave[j]][p].size() * window;
+    }
+    task_pool().parallel_for(wave.size(), wave_cost, [&](size_t begin, size_t end) {
+      for (size_t j = begin; j < end; j++) {
+        for (size_t p = 0; p < paths[wave[j]].size(); p++) {
+          burn_stream_path(paths[wave[j]][p], z, drop, window, monotone);
+        }
+      }
+    });
+  }
+  return dem;
+}
@@ -0,0 +1,197 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "check_inputs.h"
+#include "CollectorList.h"
+
+// Web mercator tile coverage
+//
+// Coordinates are projected once to unit spherical mercator (x and y in [0, 1],
+// y down from the north edge), then scaled by 2^zoom to tile units for each
+// zoom level. Tiles are found with "all touched" semantics: a tile is
+// covered if the feature intersects it at all, not only its centre.
+
+// Latitude limit of the square web mercator world
+#define MERCATOR_MAX_LAT 85.0511287798066
+
+struct MercatorRing {
+  std::vector<double> x, y;  // unit mercator
+};
+
+// Collect each matrix of a (multi)polygon or (multi)linestring as a projected ring
+void mercator_rings(Rcpp::RObject geometry, std::vector<MercatorRing> &rings) {
+  switch(geometry.sexp_type()) {
+  case REALSXP: {
+    //if the object is numeric, it an Nx2 matrix of longitude, latitude
+    Rcpp::NumericMatrix mat(geometry);
+    MercatorRing ring;
+    for (int i = 0; i < mat.nrow(); i++) {
+      double lat = std::max(std::min(mat(i, 1), MERCATOR_MAX_LAT), -MERCATOR_MAX_LAT);
+      double s = std::sin(lat * M_PI / 180.0);
+      ring.x.push_back((mat(i, 0) + 180.0) / 360.0);
+      ring.y.push_back(0.5 - std::log((1.0 + s) / (1.0 - s)) / (4.0 * M_PI));
+    }
+    rings.push_back(ring);
+    break;
+  };
+  case VECSXP: {
+    //if the object is a list, recurse over that
+    Rcpp::List geomlist = Rcpp::as<Rcpp::List>(geometry);
+    for(Rcpp::List::iterator it = geomlist.begin();
+        it != geomlist.end();
+        ++it) {
+      mercator_rings(Rcpp::wrap(*it), rings);
+    }
+    break;
+  }
+  default: {
+    Rcpp::stop("incompatible SEXP; only accepts lists and REALSXPs");
+  }
+  }
+}
+
+// Most pieces of tile rows one feature may cover at one zoom level, each a
+// segment within a row band or a crossing of a band's edge
+#define TILE_COVER_MAX_PIECES (1 << 24)
+
+struct TileRun {
+  int row, c0, c1;
+  TileRun(int row_, int c0_, int c1_) : row(row_), c0(c0_), c1(c1_) {}
+  bool operator<(const TileRun &other) const {
+    return (row < other.row) || ((row == other.row) && (c0 < other.c0));
+  }
+};
+
+// Tiles of row r touched by the x interval [a, b], if any
+inline void push_tile_run(std::vector<TileRun> &runs, int r, double a, double b, int nmax) {
+  int c0 = std::floor(a);
+  int c1 = (b > a) ? (int)std::ceil(b) - 1 : c0;
+  c0 = std::max(c0, 0);
+  c1 = std::min(c1, nmax);
+  if (c0 <= c1) runs.push_back(TileRun(r, c0, c1));
+}
+
+// Cover of one feature at one zoom level as runs of tiles by tile row
+//
+// Per row band [r, r + 1) the feature projects onto x as the union of the
+// x-extent of every segment within the band and, for polygons, the even-odd
+// fill along the band's top and bottom lines. Both are collected by walking
+// each segment once, so the cost follows the perimeter in tiles, not the area
+// and not the rows of the feature's extent; pieces are kept by row only where
+// there are some, and a feature with more than TILE_COVER_MAX_PIECES is
+// refused rather than allocated.
+void cover_tiles(std::vector<MercatorRing> &rings, bool fill, int zoom, unsigned int poly_id,
+                 CollectorList &out_vector) {
+  typedef std::pair<int, double> Crossing;  // row line and x
+  double n = std::ldexp(1.0, zoom);
+  int nmax = (1 << zoom) - 1;
+
+  double ymin = n, ymax = 0.0;
+  for (size_t k = 0; k < rings.size(); k++) {
+    for (size_t i = 0; i < rings[k].y.size(); i++) {
+      ymin = std::min(ymin, rings[k].y[i] * n);
+      ymax = std::max(ymax, rings[k].y[i] * n);
+    }
+  }
+  if (ymin > ymax) return;
+  int r0 = std::max(std::min((int)std::floor(ymin), nmax), 0);
+  int r1 = std::max(std::min((int)std::ceil(ymax) - 1, nmax), r0);
+
+  //count the pieces first, from the rows each segment passes
+  double pieces = 0;
+  for (size_t k = 0; k < rings.size(); k++) {
+    std::vector<double> &ry = rings[k].y;
+    for (size_t i = 0; i + 1 < ry.size(); i++) {
+      double ya = std::max(std::min(ry[i], ry[i + 1]) * n, (double)r0);
+      double yb = std::min(std::max(ry[i], ry[i + 1]) * n, (double)r1 + 1);
+      pieces += (fill ? 2 : 1) * (std::max(std::ceil(yb) - std::floor(ya), 0.0) + 1);
+    }
+  }
+  if (pieces > TILE_COVER_MAX_PIECES) {
+    Rcpp::stop("tile cover of feature %i is too large at zoom %i", (int)poly_id + 1, zoom);
+  }
+
+  std::vector<TileRun> runs;
+  std::vector<Crossing> lines;  // crossings of the row lines y = r0 .. r1 + 1
+  for (size_t k = 0; k < rings.size(); k++) {
+    std::vector<double> &rx = rings[k].x, &ry = rings[k].y;
+    for (size_t i = 0; i + 1 < rx.size(); i++) {
+      double x0 = rx[i] * n, y0 = ry[i] * n, x1 = rx[i + 1] * n, y1 = ry[i + 1] * n;
+      double ya = std::min(y0, y1), yb = std::max(y0, y1);
+      if (ya == yb) {
+        int r = std::floor(ya);
+        if (r >= r0 && r <= r1) push_tile_run(runs, r, std::min(x0, x1), std::max(x0, x1), nmax);
+        continue;
+      }
+      double dxdy = (x1 - x0) / (y1 - y0);
+      //x-extent of the segment within each row band it passes through
+      int ra = std::max((int)std::floor(ya), r0), rb = std::min((int)std::ceil(yb) - 1, r1);
+      for (int r = ra; r <= rb; r++) {
+        double xt = x0 + (std::max(ya, (double)r) - y0) * dxdy;
+        double xb = x0 + (std::min(yb, (double)r + 1) - y0) * dxdy;
+        push_tile_run(runs, r, std::min(xt, xb), std::max(xt, xb), nmax);
+      }
+      //crossings of the row boundaries, half open so shared vertices count once
+      if (fill) {
+        int la = std::max((int)std::ceil(ya), r0), lb = std::min((int)std::ceil(yb) - 1, r1 + 1);
+        for (int line = la; line <= lb; line++) {
+          lines.push_back(Crossing(line, x0 + (line - y0) * dxdy));
+        }
+      }
+    }
+  }
+
+  //even-odd fill along each boundary line touches the rows either side of it
+  std::sort(lines.begin(), lines.end());
+  for (size_t i = 0; i + 1 < lines.size(); ) {
+    if (lines[i].first != lines[i + 1].first) {
+      i++;
+      continue;
+    }
+    int line = lines[i].first;
+    if (line > r0) push_tile_run(runs, line - 1, lines[i].second, lines[i + 1].second, nmax);
+    if (line <= r1) push_tile_run(runs, line, lines[i].second, lines[i + 1].second, nmax);
+    i += 2;
+  }
+
+  //merge overlapping and adjacent runs of tiles in each row
+  std::sort(runs.begin(), runs.end());
+  size_t i = 0;
+  while (i < runs.size()) {
+    int r = runs[i].row, c0 = runs[i].c0, c1 = runs[i].c1;
+    for (i++; i < runs.size() && runs[i].row == r && runs[i].c0 <= c1 + 1; i++) {
+      c1 = std::max(c1, runs[i].c1);
+    }
+    out_vector.push_back(Rcpp::IntegerVector::create(c0, c1, r, zoom, poly_id));
+  }
+}
+
+// Enumerate the web mercator z/x/y tiles touched by longitude/latitude features
+//
+// @param sf an [sf::sf()] object in longitude/latitude with a geometry column of
+// POLYGON, MULTIPOLYGON, LINESTRING or MULTILINESTRING
+// @param zoom integer vector of zoom levels (0 to 30)
+// @return list of records (xstart, xend, y, zoom, poly_id), runs of tile x
+// (inclusive) along tile row y, zero-based as in the XYZ scheme
+// [[Rcpp::export]]
+Rcpp::List tile_cover(Rcpp::DataFrame &sf,
+                      Rcpp::IntegerVector &zoom) {
+  Rcpp::List geometries;
+  bool polygonal = check_inputs_polygon_or_line(sf, geometries);
+  for (R_xlen_t z = 0; z < zoom.size(); z++) {
+    if (zoom[z] == NA_INTEGER || zoom[z] < 0 || zoom[z] > 30) {
+      Rcpp::stop("zoom must be between 0 and 30");
+    }
+  }
+
+  CollectorList out_vector;
+  std::vector<MercatorRing> rings;
+  Rcpp::List::iterator g = geometries.begin();
+  for(; g != geometries.end(); ++g) {
+    rings.clear();
+    mercator_rings( (*g), rings);
+    for (R_xlen_t z = 0; z < zoom.size(); z++) {
+      cover_tiles(rings, polygonal, zoom[z], g.index(), out_vector);
+    }
+  }
+  return out_vector.vector();
+}
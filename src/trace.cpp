@@ -0,0 +1,85 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "trace.h"
+
+#include <cstdio>
+
+#ifdef CONTROLLEDBURN_TRACE
+
+#include <memory>
+#include <mutex>
+
+// Buffers of every thread that has traced, kept for the session
+static std::mutex trace_mutex;
+static std::vector<std::unique_ptr<TraceBuffer> > trace_buffers;
+
+TraceBuffer &trace_buffer() {
+  thread_local TraceBuffer *buffer = NULL;
+  if (buffer == NULL) {
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    trace_buffers.push_back(std::unique_ptr<TraceBuffer>(new TraceBuffer(trace_buffers.size())));
+    buffer = trace_buffers.back().get();
+  }
+  return *buffer;
+}
+
+int64_t trace_now() {
+  typedef std::chrono::steady_clock clock;
+  static const clock::time_point start = clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+}
+
+#endif
+
+// Whether tracing was compiled in
+//
+// @return TRUE when the package was built with CONTROLLEDBURN_TRACE
+// [[Rcpp::export]]
+bool trace_enabled() {
+#ifdef CONTROLLEDBURN_TRACE
+  return true;
+#else
+  return false;
+#endif
+}
+
+// Write traced native work as Chrome trace JSON
+//
+// Events recorded since the last call are written as complete ("X") events
+// with microsecond times, one track per thread, and are then forgotten. Call
+// between burns, while no native work is running. A thread keeps only its
+// most recent 65536 events.
+//
+// @param path file to write, open in chrome://tracing or ui.perfetto.dev
+// @return the number of events written
+// [[Rcpp::export]]
+double trace_write(std::string path) {
+#ifdef CONTROLLEDBURN_TRACE
+  FILE *file = std::fopen(path.c_str(), "w");
+  if (file == NULL) Rcpp::stop("cannot open trace file for writing");
+  std::fprintf(file, "{\"traceEvents\":[");
+  double written = 0;
+  std::lock_guard<std::mutex> lock(trace_mutex);
+  for (size_t b = 0; b < trace_buffers.size(); b++) {
+    TraceBuffer &buffer = *trace_buffers[b];
+    size_t head = buffer.head.load(std::memory_order_acquire);
+    size_t first = std::max(buffer.tail, head > TraceBuffer::capacity ? head - TraceBuffer::capacity : 0);
+    for (size_t i = first; i < head; i++) {
+      const TraceEvent &e = buffer.events[i % TraceBuffer::capacity];
+      std::fprintf(file, "%s\n{\"name\":\"%s\",\"cat\":\"controlledburn\",\"ph\":\"X\","
+                   "\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d,\"args\":{\"feature\":%ld}}",
+                   written > 0 ? "," : "", e.phase, e.begin / 1000.0, (e.end - e.begin) / 1000.0,
+                   buffer.thread, e.feature);
+      written++;
+    }
+    buffer.tail = head;
+  }
+  std::fprintf(file, "\n]}\n");
+  if (std::fclose(file) != 0) Rcpp::stop("failed writing trace file");
+  return written;
+#else
+  (void)path;
+  Rcpp::stop("tracing is not compiled in, build with -DCONTROLLEDBURN_TRACE");
+  return 0;
+#endif
+}
@@ -0,0 +1,75 @@
+#ifndef TRACE_EVENTS
+#define TRACE_EVENTS
+
+// Optional tracing of native work
+//
+// Built with CONTROLLEDBURN_TRACE defined (for example PKG_CPPFLAGS in
+// ~/.R/Makevars), TRACE_SCOPE(phase, feature) records the begin and end of
+// the enclosing scope with the thread, phase name and feature id, and
+// trace_write() saves everything recorded as Chrome trace JSON for
+// chrome://tracing or Perfetto. Each thread writes to its own fixed ring
+// buffer with no locks, keeping the most recent events. Without the flag
+// TRACE_SCOPE compiles to nothing.
+
+#ifdef CONTROLLEDBURN_TRACE
+
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+#include <vector>
+
+struct TraceEvent {
+  const char *phase;  // a string literal
+  long feature;  // -1 for none
+  int64_t begin, end;  // nanoseconds from the start of the session
+};
+
+// One thread's events, written only by that thread
+class TraceBuffer {
+public:
+  static const size_t capacity = 1 << 16;
+
+  explicit TraceBuffer(int thread) : thread(thread), head(0), tail(0), events(capacity) {}
+
+  void record(const TraceEvent &event) {
+    size_t at = head.load(std::memory_order_relaxed);
+    events[at % capacity] = event;
+    head.store(at + 1, std::memory_order_release);
+  }
+
+  const int thread;
+  std::atomic<size_t> head;  // events ever recorded
+  size_t tail;  // events already written out, used on the R thread only
+  std::vector<TraceEvent> events;
+};
+
+extern TraceBuffer &trace_buffer();
+extern int64_t trace_now();
+
+class TraceScope {
+public:
+  TraceScope(const char *phase, long feature) {
+    event_.phase = phase;
+    event_.feature = feature;
+    event_.begin = trace_now();
+  }
+  ~TraceScope() {
+    event_.end = trace_now();
+    trace_buffer().record(event_);
+  }
+
+private:
+  TraceEvent event_;
+};
+
+#define TRACE_CONCAT2(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT2(a, b)
+#define TRACE_SCOPE(phase, feature) TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(phase, feature)
+
+#else
+
+#define TRACE_SCOPE(phase, feature) do {} while (0)
+
+#endif
+
+#endif
@@ -0,0 +1,252 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "edge.h"
+#include "check_inputs.h"
+
+#include "edgelist.h"
+#include "rasterize.h"
+#include "trapezoid.h"
+
+// Event to event sweep
+//
+// Rows between two edge events (an edge starting or ending) have the same
+// active edges, so rather than sorting and pairing them on every row the
+// sweep records each filled pair of edges once, as a trapezoid, up to the
+// next event. When two active edges swap order before the next event
+// (crossing rings or self-intersections) the interval is cut at the swap, so
+// the even-odd pairs hold for every row of a trapezoid. The output follows
+// the number of edges rather than the number of rows.
+//
+// x is stepped row by row in long double exactly as scan_polygon_edges()
+// steps it, by adding dxdy, and trapezoids keep x and dxdy at full precision,
+// so decoding from row0 by the same additions gives the sweep's columns and
+// the spans of burn_polygon() cell for cell. In R records each long double is
+// held as TRAPEZOID_TERMS doubles that sum to it exactly.
+
+// Column of an edge crossing, clamped and rounded as scan_polygon_edges() does
+inline unsigned int trapezoid_col(long double x, RasterInfo &ras) {
+  return (x < 0.0) ? 0.0 : (x >= ras.ncold ? (ras.ncold - 1) : std::ceil(x));
+}
+
+// Split a long double into doubles summing to it, largest first
+inline void split_long_double(long double x, double *terms) {
+  for (int i = 0; i < TRAPEZOID_TERMS; i++) {
+    terms[i] = (double)x;
+    x -= terms[i];
+  }
+}
+
+inline long double join_long_double(const double *terms) {
+  long double x = 0;
+  for (int i = TRAPEZOID_TERMS - 1; i >= 0; i--) x += terms[i];
+  return x;
+}
+
+void scan_polygon_trapezoids(std::list<Edge_polygon> &edges, RasterInfo &ras,
+                             std::vector<Trapezoid> &traps, unsigned int poly_id) {
+  std::list<Edge_polygon>::iterator it, next;
+  if (edges.empty()) return;
+  edges.sort(less_by_ystart());
+
+  std::list<Edge_polygon> active_edges;
+  unsigned int yline(edges.front().ystart);
+
+  while(
+    (yline < ras.nrow) &&
+      (!(active_edges.empty() && edges.empty()))
+  ) {
+    while(edges.size() && (edges.front().ystart <= yline)) {
+      active_edges.splice(active_edges.end(), edges, edges.begin());
+    }
+    active_edges.sort(less_by_x());
+
+    //fill between odd and even edges, from this row to the next event
+    size_t first = traps.size();
+    for(it = active_edges.begin(); it != active_edges.end(); it++) {
+      next = it;
+      if (++next == active_edges.end()) break;
+      Trapezoid trap;
+      trap.row0 = yline;
+      trap.poly_id = poly_id;
+      trap.x_left0 = (*it).x;
+      trap.dxdy_left = (*it).dxdy;
+      trap.x_right0 = (*next).x;
+      trap.dxdy_right = (*next).dxdy;
+      traps.push_back(trap);
+      it = next;
+    }
+
+    //step the edges row by row as the sweep does, up to the first row on
+    //which an edge starts or ends, neighbouring edges change order or the
+    //grid ends
+    bool event = false;
+    while (!event) {
+      yline++;
+      event = (yline >= ras.nrow) || (edges.size() && edges.front().ystart <= yline);
+      it = active_edges.begin();
+      while(it != active_edges.end()) {
+        if((*it).yend <= yline) {
+          it = active_edges.erase(it);
+          event = true;
+        } else {
+          (*it).x += (*it).dxdy;
+          it++;
+        }
+      }
+      for(it = active_edges.begin(); !event && it != active_edges.end(); it++) {
+        next = it;
+        if (++next == active_edges.end()) break;
+        event = (*it).x > (*next).x;
+      }
+    }
+    for (size_t i = first; i < traps.size(); i++) traps[i].row1 = yline - 1;
+  }
+}
+
+// Spans of a group of trapezoids sharing rows, row by row in the order the
+// sweep would produce them, limited to first_row to last_row
+void trapezoid_rows(const Trapezoid *group, size_t n, RasterInfo &ras,
+                    unsigned int first_row, unsigned int last_row, std::vector<Span> &spans) {
+  if (n == 0) return;
+  unsigned int r0 = std::max(group[0].row0, first_row);
+  unsigned int r1 = std::min(group[0].row1, last_row);
+  if (r0 > r1) return;
+  //x on row0, stepped by the sweep's additions to each row decoded
+  std::vector<long double> left(n), right(n);
+  for (size_t i = 0; i < n; i++) {
+    left[i] = group[i].x_left0;
+    right[i] = group[i].x_right0;
+  }
+  for (unsigned int r = group[0].row0; r <= r1; r++) {
+    for (size_t i = 0; i < n && r >= r0; i++) {
+      record_polygon_scanline(spans, trapezoid_col(left[i], ras), trapezoid_col(right[i], ras),
+                              r, group[i].poly_id);
+    }
+    for (size_t i = 0; i < n; i++) {
+      left[i] += group[i].dxdy_left;
+      right[i] += group[i].dxdy_right;
+    }
+  }
+}
+
+// Rasterize polygons as trapezoids between edge events
+//
+// @param sf an [sf::sf()] object with a geometry column of POLYGON and/or
+// MULTIPOLYGON objects.
+// @param extent numeric vector c(xmin, xmax, ymin , ymax)
+// @param dimension integer vector c(ncol, nrow)
+// @return list of numeric records (row0, row1, x_left0, dxdy_left, x_right0,
+// dxdy_right, poly_id), rows inclusive and x in column units on row0 with
+// cell centres at whole numbers, see trapezoid_spans(). Each x and dxdy is
+// the sweep's long double as doubles summing to it, one per value where long
+// double is double and two on x86, so records are 7 or 11 long.
+// [[Rcpp::export]]
+Rcpp::List burn_polygon_trapezoids(Rcpp::DataFrame &sf,
+                                   Rcpp::NumericVector &extent,
+                                   Rcpp::IntegerVector &dimension) {
+  Rcpp::List polygons;
+  check_inputs_polygon(sf, polygons);  // Also fills in polygons
+
+  RasterInfo ras(extent, dimension);
+  std::vector<Feature> features;
+  features_from_list(polygons, features);
+  std::vector< std::vector<Trapezoid> > parts(features.size());
+  double cost = 0;
+  for (size_t i = 0; i < features.size(); i++) cost += feature_cost(features[i], ras);
+  task_pool().parallel_for(features.size(), cost, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      std::list<Edge_polygon> edges;
+      edgelist_feature(features[i], ras, edges);
+      scan_polygon_trapezoids(edges, ras, parts[i], i);
+    }
+  });
+
+  size_t n = 0;
+  for (size_t i = 0; i < parts.size(); i++) n += parts[i].size();
+  CollectorList out_vector(n + 1);
+  for (size_t i = 0; i < parts.size(); i++) {
+    for (size_t j = 0; j < parts[i].size(); j++) {
+      const Trapezoid &trap = parts[i][j];
+      Rcpp::NumericVector rec(TRAPEZOID_RECORD);
+      double *r = rec.begin();
+      r[0] = trap.row0;
+      r[1] = trap.row1;
+      split_long_double(trap.x_left0, r + 2);
+      split_long_double(trap.dxdy_left, r + 2 + TRAPEZOID_TERMS);
+      split_long_double(trap.x_right0, r + 2 + 2 * TRAPEZOID_TERMS);
+      split_long_double(trap.dxdy_right, r + 2 + 3 * TRAPEZOID_TERMS);
+      r[TRAPEZOID_RECORD - 1] = trap.poly_id;
+      out_vector.push_back(rec);
+    }
+  }
+  return out_vector.vector();
+}
+
+// Whether a record field is a whole number from 0 to max
+inline bool trapezoid_count(double x, double max) {
+  return R_FINITE(x) && x >= 0 && x <= max && x == std::floor(x);
+}
+
+// Decode trapezoids to spans
+//
+// @param index list of records from burn_polygon_trapezoids() on this
+// machine, in the order given
+// @param dimension integer vector c(ncol, nrow) of the grid they were burned on
+// @param first_row,last_row zero-based rows to decode, last_row -1 for the
+// last row of the grid
+// @return list of records (xstart, xend, row, poly_id) as from burn_polygon()
+// for those rows, in the same order
+// [[Rcpp::export]]
+Rcpp::List trapezoid_spans(Rcpp::List &index,
+                           Rcpp::IntegerVector &dimension,
+                           int first_row = 0,
+                           int last_row = -1) {
+  Rcpp::NumericVector extent = Rcpp::NumericVector::create(0, dimension[0], 0, dimension[1]);
+  RasterInfo ras(extent, dimension);
+  if (last_row < 0) last_row = ras.nrow - 1;
+  if (first_row < 0 || first_row > last_row) Rcpp::stop("rows must be in order and not negative");
+
+  std::vector<Trapezoid> traps(index.size());
+  for (R_xlen_t i = 0; i < index.size(); i++) {
+    SEXP rec = index[i];
+    if (TYPEOF(rec) != REALSXP || Rf_xlength(rec) != TRAPEZOID_RECORD) {
+      Rcpp::stop("index records must be numeric (row0, row1, x_left0, dxdy_left, x_right0, dxdy_right, poly_id) of length %i",
+                 TRAPEZOID_RECORD);
+    }
+    const double *r = REAL(rec);
+    if (!trapezoid_count(r[0], r[1]) || !trapezoid_count(r[1], ras.nrow - 1.0)) {
+      Rcpp::stop("index record rows must be 0 <= row0 <= row1 < nrow");
+    }
+    if (!trapezoid_count(r[TRAPEZOID_RECORD - 1], INT_MAX)) {
+      Rcpp::stop("index record poly_id must be a whole number, not negative");
+    }
+    for (int k = 2; k < TRAPEZOID_RECORD - 1; k++) {
+      if (!R_FINITE(r[k])) Rcpp::stop("index record x and dxdy must be finite");
+    }
+    traps[i].row0 = r[0];
+    traps[i].row1 = r[1];
+    traps[i].x_left0 = join_long_double(r + 2);
+    traps[i].dxdy_left = join_long_double(r + 2 + TRAPEZOID_TERMS);
+    traps[i].x_right0 = join_long_double(r + 2 + 2 * TRAPEZOID_TERMS);
+    traps[i].dxdy_right = join_long_double(r + 2 + 3 * TRAPEZOID_TERMS);
+    traps[i].poly_id = r[TRAPEZOID_RECORD - 1];
+  }
+
+  //trapezoids of one event share rows, and events follow each other down a
+  //feature, as burn_polygon_trapezoids() writes them
+  std::vector<Span> spans;
+  size_t i = 0;
+  while (i < traps.size()) {
+    size_t j = i + 1;
+    while (j < traps.size() && traps[j].row0 == traps[i].row0 && traps[j].poly_id == traps[i].poly_id) {
+      if (traps[j].row1 != traps[i].row1) Rcpp::stop("trapezoids starting on one row must end on one row");
+      j++;
+    }
+    if (j < traps.size() && traps[j].poly_id == traps[i].poly_id && traps[j].row0 <= traps[i].row1) {
+      Rcpp::stop("trapezoids must be in the order of burn_polygon_trapezoids()");
+    }
+    trapezoid_rows(&traps[i], j - i, ras, first_row, last_row, spans);
+    i = j;
+  }
+  return spans_to_list(spans);
+}
@@ -0,0 +1,32 @@
+#ifndef TRAPEZOID
+#define TRAPEZOID
+
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "edge.h"
+#include "span.h"
+
+#include <cfloat>
+
+// The region between a left and a right edge over rows row0 to row1
+// (inclusive), in which no edge starts, ends or changes order. x is in the
+// sweep's column units on row0, and the spans of every row follow by adding
+// each side's dxdy once per row, as the sweep does.
+struct Trapezoid {
+  unsigned int row0, row1, poly_id;
+  long double x_left0, dxdy_left, x_right0, dxdy_right;
+};
+
+// Doubles needed to hold a long double exactly: one where long double is
+// double, two for x87 extended precision, three for quad precision
+#define TRAPEZOID_TERMS ((LDBL_MANT_DIG + 52) / 53)
+// Length of a trapezoid record in R, (row0, row1, x_left0, dxdy_left,
+// x_right0, dxdy_right, poly_id) with each x and dxdy as TRAPEZOID_TERMS
+#define TRAPEZOID_RECORD (3 + 4 * TRAPEZOID_TERMS)
+
+extern void scan_polygon_trapezoids(std::list<Edge_polygon> &edges, RasterInfo &ras,
+                                    std::vector<Trapezoid> &traps, unsigned int poly_id);
+extern void trapezoid_rows(const Trapezoid *group, size_t n, RasterInfo &ras,
+                           unsigned int first_row, unsigned int last_row, std::vector<Span> &spans);
+
+#endif
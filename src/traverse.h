@@ -0,0 +1,70 @@
+#ifndef TRAVERSE
+#define TRAVERSE
+
+#include "edge.h"
+#include <limits>
+
+// Exact cell traversal of a line segment (Amanatides and Woo, 1987)
+//
+// Steps from cell to cell in the order the segment passes through them,
+// calling visit(col, row, length) with the length of the segment within each
+// cell, in map units. The segment is clipped to the grid first, cells are
+// bounded by their edges (not centres) and a segment running exactly through a
+// cell corner passes between the diagonal cells without touching either side.
+template <class Visit>
+inline void traverse_segment(double x0, double y0, double x1, double y1,
+                             RasterInfo &ras, Visit visit) {
+  double u0 = (x0 - ras.xmin)/ras.xres, v0 = (ras.ymax - y0)/ras.yres;
+  double du = (x1 - x0)/ras.xres, dv = (y0 - y1)/ras.yres;
+  double length = std::sqrt((x1 - x0) * (x1 - x0) + (y1 - y0) * (y1 - y0));
+  if (length == 0) return;
+
+  //clip the parameter range to the grid (Liang-Barsky)
+  double t0 = 0, t1 = 1;
+  double p[4] = {-du, du, -dv, dv};
+  double q[4] = {u0, ras.ncold - u0, v0, ras.nrowd - v0};
+  for (int i = 0; i < 4; i++) {
+    if (p[i] == 0) {
+      if (q[i] < 0) return;
+    } else {
+      double t = q[i]/p[i];
+      if (p[i] < 0) {
+        t0 = std::max(t0, t);
+      } else {
+        t1 = std::min(t1, t);
+      }
+    }
+  }
+  if (t0 >= t1) return;
+
+  //cell of the start, taking the one the segment heads into when on an edge
+  double us = u0 + t0 * du, vs = v0 + t0 * dv;
+  long col = std::floor(us), row = std::floor(vs);
+  if (du < 0 && us == col) col--;
+  if (dv < 0 && vs == row) row--;
+  col = std::max(std::min(col, (long)ras.ncol - 1), 0L);
+  row = std::max(std::min(row, (long)ras.nrow - 1), 0L);
+
+  const double inf = std::numeric_limits<double>::infinity();
+  int step_col = (du > 0) ? 1 : -1, step_row = (dv > 0) ? 1 : -1;
+  double tdelta_col = (du != 0) ? 1.0/std::fabs(du) : inf;
+  double tdelta_row = (dv != 0) ? 1.0/std::fabs(dv) : inf;
+  double tmax_col = (du > 0) ? (col + 1 - u0)/du : ((du < 0) ? (col - u0)/du : inf);
+  double tmax_row = (dv > 0) ? (row + 1 - v0)/dv : ((dv < 0) ? (row - v0)/dv : inf);
+
+  double t = t0;
+  while (t < t1 && col >= 0 && col < (long)ras.ncol && row >= 0 && row < (long)ras.nrow) {
+    double tnext = std::min(std::min(tmax_col, tmax_row), t1);
+    if (tnext > t) visit((unsigned int)col, (unsigned int)row, (tnext - t) * length);
+    t = std::max(t, tnext);
+    if (tmax_col < tmax_row) {
+      col += step_col;
+      tmax_col += tdelta_col;
+    } else {
+      row += step_row;
+      tmax_row += tdelta_row;
+    }
+  }
+}
+
+#endif
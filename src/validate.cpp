@@ -0,0 +1,83 @@
+#include "Rcpp.h"
+using namespace Rcpp;
+#include "edge.h"
+#include "check_inputs.h"
+
+#include "edgelist.h"
+#include "rasterize.h"
+
+// Sweep one feature checking for crossed edges, and sweep it again with the
+// nonzero rule if it has any and that was asked for
+void rasterize_feature_checked(const Feature &feature, RasterInfo &ras, std::vector<Span> &spans,
+                               unsigned int poly_id, bool nonzero, std::vector<unsigned int> &rows) {
+  std::list<Edge_polygon> edges;
+  edgelist_feature(feature, ras, edges);
+  SweepCheck check;
+  if (!nonzero) {
+    scan_polygon_edges(edges, ras, spans, poly_id, &check);
+    rows.swap(check.rows);
+    return;
+  }
+  std::list<Edge_polygon> again(edges);
+  std::vector<Span> checked;
+  scan_polygon_edges(edges, ras, checked, poly_id, &check);
+  rows.swap(check.rows);
+  if (rows.empty()) {
+    spans.insert(spans.end(), checked.begin(), checked.end());
+    return;
+  }
+  SweepCheck winding;
+  winding.nonzero = true;
+  scan_polygon_edges(again, ras, spans, poly_id, &winding);
+}
+
+// Rasterize polygons, reporting rows where edges cross
+//
+// Crossings are found while sweeping, from active edges that change order
+// between rows, so invalid rings are found without a separate validity
+// check. Features with crossings can be filled by the nonzero winding rule,
+// which for a self-intersecting ring fills every loop instead of leaving the
+// doubly wound parts empty.
+//
+// @param sf an [sf::sf()] object with a geometry column of POLYGON and/or
+// MULTIPOLYGON objects.
+// @param extent numeric vector c(xmin, xmax, ymin , ymax)
+// @param dimension integer vector c(ncol, nrow)
+// @param nonzero fill features with crossings by nonzero winding
+// @return list with index, the records (xstart, xend, row, poly_id) as from
+// burn_polygon(), and poly_id and row, integer vectors of each row on which
+// a feature's edges were found to have crossed (zero-based)
+// [[Rcpp::export]]
+Rcpp::List burn_polygon_checked(Rcpp::DataFrame &sf,
+                                Rcpp::NumericVector &extent,
+                                Rcpp::IntegerVector &dimension,
+                                bool nonzero = false) {
+  Rcpp::List polygons;
+  check_inputs_polygon(sf, polygons);  // Also fills in polygons
+
+  RasterInfo ras(extent, dimension);
+  std::vector<Feature> features;
+  features_from_list(polygons, features);
+  std::vector< std::vector<Span> > parts(features.size());
+  std::vector< std::vector<unsigned int> > rows(features.size());
+  double cost = 0;
+  for (size_t i = 0; i < features.size(); i++) cost += feature_cost(features[i], ras);
+  task_pool().parallel_for(features.size(), cost, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      rasterize_feature_checked(features[i], ras, parts[i], i, nonzero, rows[i]);
+    }
+  });
+
+  std::vector<Span> spans;
+  std::vector<int> bad_id, bad_row;
+  for (size_t i = 0; i < parts.size(); i++) {
+    spans.insert(spans.end(), parts[i].begin(), parts[i].end());
+    for (size_t j = 0; j < rows[i].size(); j++) {
+      bad_id.push_back(i);
+      bad_row.push_back(rows[i][j]);
+    }
+  }
+  return Rcpp::List::create(Rcpp::Named("index") = spans_to_list(spans),
+                            Rcpp::Named("poly_id") = Rcpp::wrap(bad_id),
+                            Rcpp::Named("row") = Rcpp::wrap(bad_row));
+}
@@ -0,0 +1,114 @@
+#include "wkb.h"
+#include <cstring>
+#include <stdexcept>
+
+class WKBReader {
+public:
+  WKBReader(const unsigned char *wkb, size_t size) : p_(wkb), end_(wkb + size), swap_(false) {}
+
+  void read_geometry(Feature &feature) {
+    unsigned char order = read_byte();
+    bool swap_parent = swap_;
+    // 1 is little endian (NDR)
+    swap_ = ((order == 1) != host_little_endian());
+
+    uint32_t type = read_uint32();
+    bool has_z = (type & 0x80000000) != 0, has_m = (type & 0x40000000) != 0;
+    if (type & 0x20000000) read_uint32();  // EWKB SRID
+    type &= 0x0fffffff;
+    if (type >= 3000) {
+      has_z = has_m = true;
+    } else if (type >= 2000) {
+      has_m = true;
+    } else if (type >= 1000) {
+      has_z = true;
+    }
+    int ndim = 2 + has_z + has_m;
+
+    switch (type % 1000) {
+    case 1:
+      skip(ndim * 8);
+      break;
+    case 2:
+      read_ring(feature, ndim);
+      break;
+    case 3: {
+      uint32_t nring = read_uint32();
+      for (uint32_t i = 0; i < nring; i++) read_ring(feature, ndim);
+      break;
+    }
+    case 4: case 5: case 6: case 7: {
+      uint32_t ngeom = read_uint32();
+      for (uint32_t i = 0; i < ngeom; i++) read_geometry(feature);
+      break;
+    }
+    default:
+      throw std::runtime_error("unsupported WKB geometry type");
+    }
+    swap_ = swap_parent;
+  }
+
+private:
+  const unsigned char *p_, *end_;
+  bool swap_;
+
+  static bool host_little_endian() {
+    uint16_t one = 1;
+    return *(unsigned char *)&one == 1;
+  }
+
+  void need(size_t n) {
+    if ((size_t)(end_ - p_) < n) throw std::runtime_error("WKB is truncated");
+  }
+
+  void skip(size_t n) {
+    need(n);
+    p_ += n;
+  }
+
+  unsigned char read_byte() {
+    need(1);
+    return *p_++;
+  }
+
+  void read_bytes(unsigned char *out, size_t n) {
+    need(n);
+    if (swap_) {
+      for (size_t i = 0; i < n; i++) out[i] = p_[n - 1 - i];
+    } else {
+      std::memcpy(out, p_, n);
+    }
+    p_ += n;
+  }
+
+  uint32_t read_uint32() {
+    uint32_t value;
+    read_bytes((unsigned char *)&value, 4);
+    return value;
+  }
+
+  double read_double() {
+    double value;
+    read_bytes((unsigned char *)&value, 8);
+    return value;
+  }
+
+  void read_ring(Feature &feature, int ndim) {
+    uint32_t npoint = read_uint32();
+    need((size_t)npoint * ndim * 8);
+    Ring ring;
+    ring.x.resize(npoint);
+    ring.y.resize(npoint);
+    for (uint32_t i = 0; i < npoint; i++) {
+      ring.x[i] = read_double();
+      ring.y[i] = read_double();
+      skip((ndim - 2) * 8);
+    }
+    feature.push_back(ring);
+  }
+};
+
+void feature_from_wkb(const unsigned char *wkb, size_t size, Feature &feature) {
+  WKBReader reader(wkb, size);
+  reader.read_geometry(feature);
+}
@@ -0,0 +1,13 @@
+#ifndef WKB
+#define WKB
+
+#include "geometry.h"
+#include <stdint.h>
+
+// Decode well-known binary (ISO or extended) into the native rings of a
+// feature. Any Z or M ordinates are skipped, points contribute no ring.
+// Throws std::runtime_error on malformed input, it is safe to call away from
+// the R thread.
+extern void feature_from_wkb(const unsigned char *wkb, size_t size, Feature &feature);
+
+#endif